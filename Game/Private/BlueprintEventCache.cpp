@@ -0,0 +1,54 @@
+// @Author Fathurahman <ipat.bogor@gmail.com> @ipatizer
+#include "GamePrivatePCH.h"
+#include "Util/BlueprintEventCache.h"
+
+int32 FBlueprintEventCache::Generation = 0;
+
+FBlueprintEventCache::FBlueprintEventCache( std::initializer_list<const TCHAR*> InEventNames )
+	: EventNames( InEventNames )
+	, LastClass( nullptr )
+	, LastImplementedEvents( 0 )
+	, CachedGeneration( 0 )
+{
+	check( EventNames.Num() <= 32 );
+}
+
+uint32 FBlueprintEventCache::GetImplementedEvents( const UClass* Class ) const
+{
+	if ( CachedGeneration != Generation )
+	{
+		ImplementedEventsByClass.Empty();
+		LastClass = nullptr;
+		CachedGeneration = Generation;
+	}
+
+	if ( Class == LastClass )
+	{
+		return LastImplementedEvents;
+	}
+
+	uint32* pImplementedEvents = ImplementedEventsByClass.Find( Class );
+	if ( !pImplementedEvents )
+	{
+		// An event is implemented when the most derived function with its name does not belong to a native class.
+		uint32 ImplementedEvents = 0;
+		for ( int32 Index = 0; Index < EventNames.Num(); Index++ )
+		{
+			UFunction* Function = Class ? Class->FindFunctionByName( FName( EventNames[Index], FNAME_Find ) ) : nullptr;
+			if ( Function && !Function->GetOwnerClass()->HasAnyClassFlags( CLASS_Native ) )
+			{
+				ImplementedEvents |= 1u << Index;
+			}
+		}
+		pImplementedEvents = &ImplementedEventsByClass.Add( Class, ImplementedEvents );
+	}
+
+	LastClass = Class;
+	LastImplementedEvents = *pImplementedEvents;
+	return LastImplementedEvents;
+}
+
+void FBlueprintEventCache::InvalidateAll()
+{
+	Generation++;
+}
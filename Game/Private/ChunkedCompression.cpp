@@ -0,0 +1,143 @@
+// @Author Fathurahman <ipat.bogor@gmail.com> @ipatizer
+#include "GamePrivatePCH.h"
+#include "Util/ChunkedCompression.h"
+#include "Serialization/BufferReader.h"
+#include "Async/ParallelFor.h"
+#include "GameStats.h"
+
+/** Chunks bigger than this are refused when decompressing, so the sizes in a corrupt header can not ask for huge allocations per chunk. */
+static const int32 MaxChunkSize = 64 * 1024 * 1024;
+
+FArchive& operator<<( FArchive& Ar, FChunkedCompressionHeader& Header )
+{
+	uint8 Codec = (uint8) Header.Codec;
+	Ar << Header.Magic << Header.Version << Codec << Header.ChunkSize << Header.UncompressedSize << Header.NumChunks;
+	Header.Codec = (ESaveGameCompression) Codec;
+	return Ar;
+}
+
+ECompressionFlags FChunkedCompression::GetCompressionFlags( ESaveGameCompression Codec )
+{
+	switch ( Codec )
+	{
+	case ESaveGameCompression::Zlib:
+		return COMPRESS_ZLIB;
+	case ESaveGameCompression::Gzip:
+		return COMPRESS_GZIP;
+	default:
+		return COMPRESS_None;
+	}
+}
+
+void FChunkedCompression::Compress( ESaveGameCompression Codec, const uint8* Data, int64 Size, TArray<uint8>& OutBytes, int32 ChunkSize )
+{
+	SCOPE_CYCLE_COUNTER( STAT_GameModules_SaveGameCompress );
+	check( ChunkSize > 0 && ChunkSize <= MaxChunkSize && Size >= 0 );
+
+	const ECompressionFlags Flags = GetCompressionFlags( Codec );
+	const int32 NumChunks = (int32) FMath::DivideAndRoundUp<int64>( Size, ChunkSize );
+
+	TArray<TArray<uint8>> Chunks;
+	Chunks.SetNum( NumChunks );
+
+	ParallelFor( NumChunks, [&]( int32 Index )
+	{
+		const int64 Offset = (int64) Index * ChunkSize;
+		const int32 RawSize = (int32) FMath::Min<int64>( ChunkSize, Size - Offset );
+
+		// A chunk that does not get smaller is stored as is, so the compressed chunk never needs more room than the chunk itself.
+		TArray<uint8>& Chunk = Chunks[Index];
+		Chunk.SetNumUninitialized( RawSize );
+		int32 CompressedSize = RawSize;
+		if ( Flags != COMPRESS_None
+			&& FCompression::CompressMemory( Flags, Chunk.GetData(), CompressedSize, Data + Offset, RawSize )
+			&& CompressedSize < RawSize )
+		{
+			Chunk.SetNum( CompressedSize, false );
+		}
+		else
+		{
+			FMemory::Memcpy( Chunk.GetData(), Data + Offset, RawSize );
+		}
+	}, Flags == COMPRESS_None );
+
+	FChunkedCompressionHeader Header;
+	Header.Codec = Codec;
+	Header.ChunkSize = ChunkSize;
+	Header.UncompressedSize = Size;
+	Header.NumChunks = NumChunks;
+
+	OutBytes.Reset();
+	FMemoryWriter Writer( OutBytes );
+	Writer << Header;
+	for ( TArray<uint8>& Chunk : Chunks )
+	{
+		int32 CompressedSize = Chunk.Num();
+		Writer << CompressedSize;
+	}
+	for ( TArray<uint8>& Chunk : Chunks )
+	{
+		Writer.Serialize( Chunk.GetData(), Chunk.Num() );
+	}
+}
+
+bool FChunkedCompression::Decompress( const uint8* Data, int64 Size, TArray<uint8>& OutBytes )
+{
+	SCOPE_CYCLE_COUNTER( STAT_GameModules_SaveGameDecompress );
+
+	FBufferReader Reader( (void*) Data, Size, false );
+	FChunkedCompressionHeader Header;
+	Reader << Header;
+
+	if ( Reader.IsError() || Header.Magic != FChunkedCompressionHeader::ChunkedMagic
+		|| Header.Version < EChunkedCompressionVersion::Initial || Header.Version > EChunkedCompressionVersion::Latest
+		|| Header.Codec > ESaveGameCompression::Gzip
+		|| Header.ChunkSize <= 0 || Header.ChunkSize > MaxChunkSize || Header.UncompressedSize < 0 || Header.UncompressedSize > MAX_int32
+		|| Header.NumChunks != FMath::DivideAndRoundUp<int64>( Header.UncompressedSize, Header.ChunkSize )
+		|| Header.NumChunks * (int64) sizeof(int32) > Size - Reader.Tell() )
+	{
+		return false;
+	}
+
+	// Where each chunk starts, validated up front so the workers do not need to check anything.
+	const int32 NumChunks = Header.NumChunks;
+	TArray<int32> CompressedSizes;
+	CompressedSizes.SetNumUninitialized( NumChunks );
+	Reader.Serialize( CompressedSizes.GetData(), NumChunks * sizeof(int32) );
+
+	TArray<int64> ChunkOffsets;
+	ChunkOffsets.SetNumUninitialized( NumChunks );
+	int64 ChunkOffset = Reader.Tell();
+	for ( int32 Index = 0; Index < NumChunks; Index++ )
+	{
+		const int32 RawSize = (int32) FMath::Min<int64>( Header.ChunkSize, Header.UncompressedSize - (int64) Index * Header.ChunkSize );
+		if ( CompressedSizes[Index] <= 0 || CompressedSizes[Index] > RawSize || CompressedSizes[Index] > Size - ChunkOffset )
+		{
+			return false;
+		}
+		ChunkOffsets[Index] = ChunkOffset;
+		ChunkOffset += CompressedSizes[Index];
+	}
+
+	OutBytes.SetNumUninitialized( (int32) Header.UncompressedSize );
+
+	const ECompressionFlags Flags = GetCompressionFlags( Header.Codec );
+	FThreadSafeCounter NumErrors;
+	ParallelFor( NumChunks, [&]( int32 Index )
+	{
+		const int64 Offset = (int64) Index * Header.ChunkSize;
+		const int32 RawSize = (int32) FMath::Min<int64>( Header.ChunkSize, Header.UncompressedSize - Offset );
+		const uint8* Chunk = Data + ChunkOffsets[Index];
+
+		if ( CompressedSizes[Index] == RawSize )
+		{
+			FMemory::Memcpy( OutBytes.GetData() + Offset, Chunk, RawSize );
+		}
+		else if ( Flags == COMPRESS_None || !FCompression::UncompressMemory( Flags, OutBytes.GetData() + Offset, RawSize, Chunk, CompressedSizes[Index] ) )
+		{
+			NumErrors.Increment();
+		}
+	}, Flags == COMPRESS_None );
+
+	return NumErrors.GetValue() == 0;
+}
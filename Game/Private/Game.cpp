@@ -2,6 +2,23 @@
 #include "GamePrivatePCH.h"
 #include "Util/GameUtil.h"
 #include "Framework/GameManager.h"
+#include "Util/BlueprintEventCache.h"
+#include "Util/GameObjectMemoryReport.h"
+#include "GameStats.h"
+
+/** Blueprint events of UGame, in the order of their names in GameEvents. */
+enum EGameEvent
+{
+	GE_Init,
+	GE_Start,
+	GE_LoadedFromRecord,
+};
+
+static FBlueprintEventCache GameEvents( {
+	TEXT("BPF_OnInit"),
+	TEXT("BPF_OnStart"),
+	TEXT("BPF_OnLoadedFromRecord"),
+} );
 
 UGame* UGame::Get( bool bChecked )
 {
@@ -42,7 +59,10 @@ void UGame::Init()
 	bIsInitialized = true;
 
 	OnInit();
-	BPF_OnInit();
+	if ( GameEvents.IsImplemented( this, GE_Init ) )
+	{
+		BPF_OnInit();
+	}
 }
 
 void UGame::Start()
@@ -50,7 +70,10 @@ void UGame::Start()
 	Init();
 	SimulationDateTime = InitialSimulationDateTime;
 	OnStart();
-	BPF_OnStart();
+	if ( GameEvents.IsImplemented( this, GE_Start ) )
+	{
+		BPF_OnStart();
+	}
 }
 
 bool UGame::LoadFromRecord(const FGameRecord& InRecord)
@@ -67,7 +90,10 @@ bool UGame::LoadFromRecord(const FGameRecord& InRecord)
 	this->Serialize( Ar );
 
 	OnLoadedFromRecord();
-	BPF_OnLoadedFromRecord();
+	if ( GameEvents.IsImplemented( this, GE_LoadedFromRecord ) )
+	{
+		BPF_OnLoadedFromRecord();
+	}
 
 	return true;
 }
@@ -89,6 +115,52 @@ bool UGame::SaveToRecord(FGameRecord& OutRecord) const
 	return true;
 }
 
+bool UGame::SaveDeltaToRecord( FGameRecord& InOutRecord )
+{
+	ensureMsgf( bIsInitialized, TEXT( "Trying to save an un-initialized game to a record." ) );
+
+	if ( ObjectTree->SaveDeltaToRecord( InOutRecord.ObjectTreeRecord ) == false )
+	{
+		return false;
+	}
+
+	InOutRecord.ByteData.Reset();
+	FMemoryWriter MemWriter( InOutRecord.ByteData );
+	FSaveGameArchive Ar( MemWriter );
+	this->Serialize( Ar );
+
+	return true;
+}
+
+bool UGame::BeginIncrementalSave( float BudgetSeconds, const FOnGameSavedToRecord& OnSaved )
+{
+	ensureMsgf( bIsInitialized, TEXT( "Trying to save an un-initialized game to a record." ) );
+
+	if ( ObjectTree->IsSaving() )
+	{
+		return false;
+	}
+
+	PendingSaveRecord = FGameRecord();
+	FMemoryWriter MemWriter( PendingSaveRecord.ByteData );
+	FSaveGameArchive Ar( MemWriter );
+	this->Serialize( Ar );
+
+	PendingSaveCompleted = OnSaved;
+	return ObjectTree->BeginIncrementalSave( BudgetSeconds, FOnGameObjectTreeSaved::CreateUObject( this, &UGame::OnObjectTreeSaved ) );
+}
+
+void UGame::OnObjectTreeSaved( bool bSuccess, FGameObjectTreeRecord& TreeRecord )
+{
+	FGameRecord Record = MoveTemp( PendingSaveRecord );
+	Record.ObjectTreeRecord = MoveTemp( TreeRecord );
+	PendingSaveRecord = FGameRecord();
+
+	FOnGameSavedToRecord OnSaved = PendingSaveCompleted;
+	PendingSaveCompleted.Unbind();
+	OnSaved.ExecuteIfBound( bSuccess, Record );
+}
+
 void UGame::Shutdown()
 {
 	if ( IsPendingKill() )
@@ -161,22 +233,24 @@ void UGame::SetSimulationDateTime(const FDateTime& InDateTime)
 
 void UGame::Tick(float DeltaTime)
 {
+	SCOPE_CYCLE_COUNTER( STAT_GameModules_GameTick );
+
 	ObjectTree->Tick( DeltaTime );
+	FGameObjectMemoryReport::TickStats( ObjectTree );
 
 	if ( bHasSimulation && bIsSimulationPaused == false )
 	{
+		FTimespan Timespan;
 		if ( bIsSimulationAffectsWorldTime )
 		{
-			FTimespan Timespan = SimulationTimespanPerSecond * DeltaTime;
-			SimulationDateTime += Timespan;
-			ObjectTree->SimulationTick( Timespan );
+			Timespan = SimulationTimespanPerSecond * DeltaTime;
 		}
 		else
 		{
-			FTimespan Timespan = SimulationTimespanPerSecond * (DeltaTime * SimulationSpeedScale);
-			SimulationDateTime += Timespan;
-			ObjectTree->SimulationTick( Timespan );
+			Timespan = SimulationTimespanPerSecond * (DeltaTime * SimulationSpeedScale);
 		}
+		SimulationDateTime += Timespan;
+		ObjectTree->SimulationTick( Timespan );
 	}
 }
 
@@ -19,7 +19,7 @@ UGameObject* UGameData::GetInstance()
 
 			UGameObjectContainer* Container = Game->GetObjectTree()->GetOrCreateContainerForObject( UGameObject::StaticClass() );
 
-			Instance = Container->GetOrCreateChild<UGameObject>( InstanceClass, InstanceID );
+			Instance = Container->GetOrCreateChild<UGameObject>( InstanceClass, *InstanceID );
 			OnInitInstance();
 			UGameObject* Object = Instance.Get();
 			BPF_OnInitInstance( Object );
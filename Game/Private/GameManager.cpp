@@ -2,6 +2,10 @@
 #include "GamePrivatePCH.h"
 #include "Framework/GameManager.h"
 #include "Util/GameUtil.h"
+#include "Util/ChunkedCompression.h"
+#include "GameStats.h"
+#include "PlatformFeatures.h"
+#include "SaveGameSystem.h"
 
 TWeakObjectPtr<UGameManager> g_Instance;
 
@@ -20,6 +24,13 @@ UGameManager::UGameManager( const FObjectInitializer& ObjectInitializer )
 	: Super( ObjectInitializer )
 {
 	SaveGameClass = USaveGameObject::StaticClass();
+	SaveGameCompression = ESaveGameCompression::None;
+	PendingSaveGame = nullptr;
+	PendingSaveUserIndex = 0;
+	DeltaSaveGame = nullptr;
+	DeltaSaveUserIndex = 0;
+	NumPendingSaveGameIO = 0;
+	bIsLoadingGame = false;
 }
 
 UGame* UGameManager::GetCurrentGame() const
@@ -51,12 +62,315 @@ void UGameManager::StopGame()
 		CurrentGame->Shutdown();
 		CurrentGame = nullptr;
 	}
+	DeltaSaveGame = nullptr;
+}
+
+//////////////////////////////////////////////////////////////////////////
+// Save game files
+//////////////////////////////////////////////////////////////////////////
+
+/** Versions of the header of the save game files, the fields a file has are read according to its version. */
+enum class EGameSaveFileVersion : int32
+{
+	/** Files with the legacy magic: UE4 version and save game class path only, never compressed. */
+	Legacy = 0,
+	/** The version follows the magic, the codec follows the save game class path. */
+	Initial,
+	/** The licensee, engine and custom versions follow the codec. */
+	AddedEngineVersions,
+
+	// -----<new versions can be added above this line>-------------------------------------------------
+	VersionPlusOne,
+	Latest = VersionPlusOne - 1
+};
+
+/**
+* Header of the save game files written by the game manager, followed by the save game object's tagged properties.
+* The properties are chunked compressed when the header has a codec, @see FChunkedCompression
+*/
+struct FGameSaveFileHeader
+{
+	enum { SaveFileMagic = 0x32534D47 };
+	enum { LegacySaveFileMagic = 0x56534D47 };
+
+	uint32 Magic = SaveFileMagic;
+	int32 FileVersion = (int32) EGameSaveFileVersion::Latest;
+	int32 UE4Version = GPackageFileUE4Version;
+	FString SaveGameClassPath;
+	ESaveGameCompression Compression = ESaveGameCompression::None;
+	int32 LicenseeUE4Version = GPackageFileLicenseeUE4Version;
+	FEngineVersion EngineVersion = GEngineVersion;
+	FCustomVersionContainer CustomVersions;
+
+	FORCEINLINE bool HasKnownMagic() const { return Magic == SaveFileMagic || Magic == LegacySaveFileMagic; }
+
+	/** The magic is read first and nothing else is read from a file that is not a save game file of the game manager, @see HasKnownMagic */
+	friend FArchive& operator<<( FArchive& Ar, FGameSaveFileHeader& Header )
+	{
+		Ar << Header.Magic;
+		if ( !Header.HasKnownMagic() )
+		{
+			return Ar;
+		}
+
+		if ( Header.Magic == LegacySaveFileMagic )
+		{
+			Header.FileVersion = (int32) EGameSaveFileVersion::Legacy;
+		}
+		else
+		{
+			Ar << Header.FileVersion;
+		}
+
+		Ar << Header.UE4Version << Header.SaveGameClassPath;
+
+		uint8 Compression = (uint8) ESaveGameCompression::None;
+		if ( Header.FileVersion >= (int32) EGameSaveFileVersion::Initial )
+		{
+			Compression = (uint8) Header.Compression;
+			Ar << Compression;
+		}
+		Header.Compression = (ESaveGameCompression) Compression;
+
+		if ( Header.FileVersion >= (int32) EGameSaveFileVersion::AddedEngineVersions )
+		{
+			Ar << Header.LicenseeUE4Version << Header.EngineVersion;
+			Header.CustomVersions.Serialize( Ar );
+		}
+		return Ar;
+	}
+
+	/** Let a reader of the save game object's properties know the versions they have been written with. */
+	void ApplyVersions( FArchive& Ar ) const
+	{
+		Ar.SetUE4Ver( UE4Version );
+		if ( FileVersion >= (int32) EGameSaveFileVersion::AddedEngineVersions )
+		{
+			Ar.SetLicenseeUE4Ver( LicenseeUE4Version );
+			Ar.SetCustomVersions( CustomVersions );
+		}
+	}
+};
+
+/** Tag of the save game files written by UGameplayStatics, the files written before it had one start with the save game class name. */
+static const int32 EngineSaveGameFileTypeTag = 0x53415647;
+
+/** A save game file that has been read and decoded on a worker thread, waiting for its object to be created on the game thread. */
+struct FGameSaveFile
+{
+	FGameSaveFileHeader Header;
+
+	TArray<uint8> Bytes;
+
+	/** Where the save game object's properties start. */
+	int64 ObjectOffset = 0;
+
+	/** Whether the file has been written by UGameplayStatics instead of the game manager. */
+	bool bIsEngineFormat = false;
+};
+
+/** The platform features module is not safe to use off the game thread, the workers are given the save game system resolved here. */
+static ISaveGameSystem* GetSaveGameSystem()
+{
+	check( IsInGameThread() );
+	return IPlatformFeaturesModule::Get().GetSaveGameSystem();
+}
+
+/** Serialize a save game object into the bytes of a file, game thread only. The properties are compressed later by CompressSaveGameFile. */
+static void WriteSaveGameFile( USaveGame* SaveGameObject, ESaveGameCompression Compression, TArray<uint8>& OutBytes )
+{
+	FMemoryWriter MemoryWriter( OutBytes, true );
+
+	FGameSaveFileHeader Header;
+	Header.SaveGameClassPath = SaveGameObject->GetClass()->GetPathName();
+	Header.Compression = Compression;
+	Header.CustomVersions = FCustomVersionContainer::GetRegistered();
+	MemoryWriter << Header;
+
+	FObjectAndNameAsStringProxyArchive Ar( MemoryWriter, false );
+	SaveGameObject->Serialize( Ar );
+}
+
+/** Compress the properties of a file written by WriteSaveGameFile with the codec of its header, safe to call from any thread. */
+static void CompressSaveGameFile( TArray<uint8>& InOutBytes )
+{
+	FGameSaveFileHeader Header;
+	FMemoryReader MemoryReader( InOutBytes, true );
+	MemoryReader << Header;
+	if ( Header.Compression == ESaveGameCompression::None )
+	{
+		return;
+	}
+
+	const int64 ObjectOffset = MemoryReader.Tell();
+	TArray<uint8> Compressed;
+	FChunkedCompression::Compress( Header.Compression, InOutBytes.GetData() + ObjectOffset, InOutBytes.Num() - ObjectOffset, Compressed );
+
+	InOutBytes.SetNum( ObjectOffset, false );
+	InOutBytes.Append( Compressed );
+}
+
+/** Whether the string the archive is at fits in what is left of it, so a file of another format can not make it allocate whatever its bytes say. */
+static bool IsStringInBounds( FArchive& Ar )
+{
+	const int64 Offset = Ar.Tell();
+	int32 SaveNum = 0;
+	Ar << SaveNum;
+	Ar.Seek( Offset );
+
+	const int64 NumBytes = SaveNum < 0 ? -(int64) SaveNum * sizeof( UCS2CHAR ) : (int64) SaveNum;
+	return !Ar.IsError() && NumBytes <= Ar.TotalSize() - Offset - (int64) sizeof( int32 );
+}
+
+/** Decode the header of a file written by UGameplayStatics the way UGameplayStatics::LoadGameFromSlot does, so the slot is not read a second time. */
+static bool ReadEngineSaveGameFile( FGameSaveFile& File )
+{
+	File.bIsEngineFormat = true;
+	File.Header.FileVersion = (int32) EGameSaveFileVersion::Legacy;
+
+	FMemoryReader MemoryReader( File.Bytes, true );
+	int32 FileTypeTag = 0;
+	MemoryReader << FileTypeTag;
+	if ( FileTypeTag == EngineSaveGameFileTypeTag )
+	{
+		int32 EngineFileVersion = 0;
+		MemoryReader << EngineFileVersion << File.Header.UE4Version << File.Header.EngineVersion;
+	}
+	else
+	{
+		MemoryReader.Seek( 0 );
+	}
+
+	if ( MemoryReader.IsError() || !IsStringInBounds( MemoryReader ) )
+	{
+		return false;
+	}
+	MemoryReader << File.Header.SaveGameClassPath;
+	File.ObjectOffset = MemoryReader.Tell();
+	return !MemoryReader.IsError();
+}
+
+/** Read a save slot and decode its header, safe to call from any thread. */
+static bool ReadSaveGameFile( ISaveGameSystem* SaveSystem, const FString& SlotName, int32 UserIndex, FGameSaveFile& OutFile )
+{
+	if ( !SaveSystem || !SaveSystem->LoadGame( false, *SlotName, UserIndex, OutFile.Bytes ) )
+	{
+		return false;
+	}
+
+	FMemoryReader MemoryReader( OutFile.Bytes, true );
+	MemoryReader << OutFile.Header;
+	if ( MemoryReader.IsError() || !OutFile.Header.HasKnownMagic() )
+	{
+		if ( !ReadEngineSaveGameFile( OutFile ) )
+		{
+			PrintLogError( "Not a save game: %s", *SlotName );
+			return false;
+		}
+		return true;
+	}
+	if ( OutFile.Header.FileVersion > (int32) EGameSaveFileVersion::Latest )
+	{
+		PrintLogError( "Save game has been written by a newer version: %s", *SlotName );
+		return false;
+	}
+
+	OutFile.ObjectOffset = MemoryReader.Tell();
+	if ( OutFile.Header.Compression == ESaveGameCompression::None )
+	{
+		return true;
+	}
+
+	TArray<uint8> Decompressed;
+	if ( !FChunkedCompression::Decompress( OutFile.Bytes.GetData() + OutFile.ObjectOffset, OutFile.Bytes.Num() - OutFile.ObjectOffset, Decompressed ) )
+	{
+		PrintLogError( "Corrupt compressed save game: %s", *SlotName );
+		return false;
+	}
+	OutFile.Bytes = MoveTemp( Decompressed );
+	OutFile.ObjectOffset = 0;
+	return true;
+}
+
+/** Create the save game object of a file that has been read, game thread only. */
+static USaveGameObject* LoadSaveGameObject( const FGameSaveFile& File )
+{
+	// UGameplayStatics writes the class name, which is looked for before being loaded as a path.
+	UClass* Class = File.bIsEngineFormat ? FindObject<UClass>( ANY_PACKAGE, *File.Header.SaveGameClassPath ) : nullptr;
+	if ( !Class )
+	{
+		Class = LoadObject<UClass>( nullptr, *File.Header.SaveGameClassPath );
+	}
+	if ( !Class || !Class->IsChildOf( USaveGameObject::StaticClass() ) )
+	{
+		PrintLogError( "Save game class is not valid: %s", *File.Header.SaveGameClassPath );
+		return nullptr;
+	}
+
+	USaveGameObject* SaveGameObject = NewObject<USaveGameObject>( GetTransientPackage(), Class );
+
+	FMemoryReader MemoryReader( File.Bytes, true );
+	File.Header.ApplyVersions( MemoryReader );
+	MemoryReader.Seek( File.ObjectOffset );
+	FObjectAndNameAsStringProxyArchive Ar( MemoryReader, true );
+	SaveGameObject->Serialize( Ar );
+
+	return Ar.IsError() ? nullptr : SaveGameObject;
+}
+
+//////////////////////////////////////////////////////////////////////////
+// Saving and loading
+//////////////////////////////////////////////////////////////////////////
+
+void UGameManager::DispatchSaveGameIO( const FString& SlotName, int32 UserIndex, TFunction<void()> Task )
+{
+	check( IsInGameThread() );
+
+	for ( auto It = SaveGameIOEvents.CreateIterator(); It; ++It )
+	{
+		if ( It.Value()->IsComplete() )
+		{
+			It.RemoveCurrent();
+		}
+	}
+
+	// A slot is never read while it is being written, nor written twice at once.
+	const FString Key = FString::Printf( TEXT( "%d/%s" ), UserIndex, *SlotName );
+	FGraphEventArray Prerequisites;
+	if ( FGraphEventRef* Pending = SaveGameIOEvents.Find( Key ) )
+	{
+		Prerequisites.Add( *Pending );
+	}
+	SaveGameIOEvents.Add( Key, FFunctionGraphTask::CreateAndDispatchWhenReady( MoveTemp( Task ), GET_STATID( STAT_GameModules_SaveGameIO ), &Prerequisites, ENamedThreads::AnyThread ) );
+}
+
+void UGameManager::WaitForSaveGameIO( const FString& SlotName, int32 UserIndex )
+{
+	check( IsInGameThread() );
+
+	const FString Key = FString::Printf( TEXT( "%d/%s" ), UserIndex, *SlotName );
+	FGraphEventRef Pending;
+	if ( SaveGameIOEvents.RemoveAndCopyValue( Key, Pending ) && !Pending->IsComplete() )
+	{
+		FTaskGraphInterface::Get().WaitUntilTaskCompletes( Pending, ENamedThreads::GameThread );
+	}
 }
 
 bool UGameManager::LoadGame( const FString& SlotName, int32 UserIndex )
 {
-	USaveGameObject* SaveGameObject = Cast<USaveGameObject>( UGameplayStatics::LoadGameFromSlot( SlotName, UserIndex ) );
+	WaitForSaveGameIO( SlotName, UserIndex );
+
+	FGameSaveFile File;
+	if ( !ReadSaveGameFile( GetSaveGameSystem(), SlotName, UserIndex, File ) )
+	{
+		return false;
+	}
 
+	return LoadGameFromObject( LoadSaveGameObject( File ), SlotName, UserIndex );
+}
+
+bool UGameManager::LoadGameFromObject( USaveGameObject* SaveGameObject, const FString& SlotName, int32 UserIndex )
+{
 	if ( !SaveGameObject )
 	{
 		return false;
@@ -68,7 +382,7 @@ bool UGameManager::LoadGame( const FString& SlotName, int32 UserIndex )
 	if ( !Class)
 	{
 		PrintLogError("GameClass is not valid");
-		return nullptr;
+		return false;
 	}
 	CurrentGame = NewObject<UGame>( Class );
 	if ( CurrentGame->LoadFromRecord( SaveGameObject->GameRecord ) == false )
@@ -79,6 +393,11 @@ bool UGameManager::LoadGame( const FString& SlotName, int32 UserIndex )
 
 	// TODO: Load world
 
+	// The loaded record is what the object tree tracks its changes against.
+	DeltaSaveGame = SaveGameObject;
+	DeltaSaveSlotName = SlotName;
+	DeltaSaveUserIndex = UserIndex;
+
 	PostLoadGame( SaveGameObject );
 	BPF_PostLoadGame( SaveGameObject );
 
@@ -87,11 +406,28 @@ bool UGameManager::LoadGame( const FString& SlotName, int32 UserIndex )
 
 bool UGameManager::SaveGame( const FString& SlotName, int32 UserIndex )
 {
-	if ( !CurrentGame )
+	USaveGameObject* SaveGameObject = SaveCurrentGameToObject();
+	if ( !SaveGameObject )
 	{
 		return false;
 	}
 
+	TArray<uint8> Bytes;
+	WriteSaveGameFile( SaveGameObject, SaveGameCompression, Bytes );
+	CompressSaveGameFile( Bytes );
+
+	WaitForSaveGameIO( SlotName, UserIndex );
+	ISaveGameSystem* SaveSystem = GetSaveGameSystem();
+	return SaveSystem && SaveSystem->SaveGame( false, *SlotName, UserIndex, Bytes );
+}
+
+USaveGameObject* UGameManager::SaveCurrentGameToObject()
+{
+	if ( !CurrentGame )
+	{
+		return nullptr;
+	}
+
 	USaveGameObject* SaveGameObject = Cast<USaveGameObject>( UGameplayStatics::CreateSaveGameObject( SaveGameClass.ResolveClass() ) );
 	check( SaveGameObject );
 
@@ -101,11 +437,166 @@ bool UGameManager::SaveGame( const FString& SlotName, int32 UserIndex )
 	// TODO: Save world
 
 	if ( CurrentGame->SaveToRecord( SaveGameObject->GameRecord ) == false )
+	{
+		return nullptr;
+	}
+	return SaveGameObject;
+}
+
+bool UGameManager::SaveGameAsync( const FString& SlotName, int32 UserIndex, FOnGameSaved OnSaved )
+{
+	USaveGameObject* SaveGameObject = SaveCurrentGameToObject();
+	if ( !SaveGameObject )
+	{
+		return false;
+	}
+
+	WriteSaveGameAsync( SaveGameObject, SlotName, UserIndex, OnSaved );
+	return true;
+}
+
+bool UGameManager::SaveGameDeltaAsync( const FString& SlotName, int32 UserIndex, FOnGameSaved OnSaved )
+{
+	if ( !CurrentGame )
+	{
+		return false;
+	}
+
+	// Deltas are only added to the record of the same slot, any other slot gets a full save that the next deltas are added to.
+	if ( !DeltaSaveGame || DeltaSaveSlotName != SlotName || DeltaSaveUserIndex != UserIndex )
+	{
+		DeltaSaveGame = Cast<USaveGameObject>( UGameplayStatics::CreateSaveGameObject( SaveGameClass.ResolveClass() ) );
+		check( DeltaSaveGame );
+		DeltaSaveSlotName = SlotName;
+		DeltaSaveUserIndex = UserIndex;
+	}
+
+	PreSaveGame( DeltaSaveGame );
+	BPF_PreSaveGame( DeltaSaveGame );
+
+	if ( CurrentGame->SaveDeltaToRecord( DeltaSaveGame->GameRecord ) == false )
+	{
+		// The record may be half updated, start over with a full save next time.
+		DeltaSaveGame = nullptr;
+		return false;
+	}
+
+	WriteSaveGameAsync( DeltaSaveGame, SlotName, UserIndex, OnSaved );
+	return true;
+}
+
+void UGameManager::WriteSaveGameAsync( USaveGameObject* SaveGameObject, const FString& SlotName, int32 UserIndex, FOnGameSaved OnSaved )
+{
+	// Objects can only be serialized on the game thread, the compression and the storage are done on a worker.
+	TSharedRef<TArray<uint8>, ESPMode::ThreadSafe> Bytes = MakeShareable( new TArray<uint8>() );
+	WriteSaveGameFile( SaveGameObject, SaveGameCompression, *Bytes );
+
+	NumPendingSaveGameIO++;
+	TWeakObjectPtr<UGameManager> WeakThis( this );
+	ISaveGameSystem* SaveSystem = GetSaveGameSystem();
+	DispatchSaveGameIO( SlotName, UserIndex, [WeakThis, SaveSystem, Bytes, SlotName, UserIndex, OnSaved]()
+	{
+		CompressSaveGameFile( *Bytes );
+
+		const bool bSuccess = SaveSystem && SaveSystem->SaveGame( false, *SlotName, UserIndex, *Bytes );
+
+		FFunctionGraphTask::CreateAndDispatchWhenReady( [WeakThis, bSuccess, OnSaved]()
+		{
+			if ( WeakThis.IsValid() )
+			{
+				WeakThis->NumPendingSaveGameIO--;
+			}
+			OnSaved.ExecuteIfBound( bSuccess );
+		}, TStatId(), nullptr, ENamedThreads::GameThread );
+	} );
+}
+
+bool UGameManager::LoadGameAsync( const FString& SlotName, int32 UserIndex, FOnGameLoaded OnLoaded )
+{
+	if ( bIsLoadingGame )
 	{
 		return false;
 	}
+	bIsLoadingGame = true;
+	NumPendingSaveGameIO++;
+
+	// The storage is read and decoded on a worker, the objects are only created back on the game thread.
+	TWeakObjectPtr<UGameManager> WeakThis( this );
+	ISaveGameSystem* SaveSystem = GetSaveGameSystem();
+	DispatchSaveGameIO( SlotName, UserIndex, [WeakThis, SaveSystem, SlotName, UserIndex, OnLoaded]()
+	{
+		TSharedRef<FGameSaveFile, ESPMode::ThreadSafe> File = MakeShareable( new FGameSaveFile() );
+		const bool bRead = ReadSaveGameFile( SaveSystem, SlotName, UserIndex, *File );
+
+		FFunctionGraphTask::CreateAndDispatchWhenReady( [WeakThis, File, bRead, SlotName, UserIndex, OnLoaded]()
+		{
+			UGameManager* This = WeakThis.Get();
+			bool bSuccess = false;
+			if ( This )
+			{
+				This->NumPendingSaveGameIO--;
+				This->bIsLoadingGame = false;
+				bSuccess = bRead && This->LoadGameFromObject( LoadSaveGameObject( *File ), SlotName, UserIndex );
+			}
+			OnLoaded.ExecuteIfBound( bSuccess );
+		}, TStatId(), nullptr, ENamedThreads::GameThread );
+	} );
+
+	return true;
+}
+
+bool UGameManager::HasPendingSaveGameIO() const
+{
+	return NumPendingSaveGameIO > 0;
+}
+
+bool UGameManager::SaveGameIncremental( const FString& SlotName, int32 UserIndex, float BudgetMilliseconds, FOnGameSaved OnSaved )
+{
+	if ( !CurrentGame || PendingSaveGame )
+	{
+		return false;
+	}
+
+	USaveGameObject* SaveGameObject = Cast<USaveGameObject>( UGameplayStatics::CreateSaveGameObject( SaveGameClass.ResolveClass() ) );
+	check( SaveGameObject );
+
+	PreSaveGame( SaveGameObject );
+	BPF_PreSaveGame( SaveGameObject );
+
+	PendingSaveGame = SaveGameObject;
+	PendingSaveSlotName = SlotName;
+	PendingSaveUserIndex = UserIndex;
+	PendingSaveCompleted = OnSaved;
+
+	if ( CurrentGame->BeginIncrementalSave( BudgetMilliseconds / 1000.0f, FOnGameSavedToRecord::CreateUObject( this, &UGameManager::OnGameSavedToRecord ) ) == false )
+	{
+		PendingSaveGame = nullptr;
+		PendingSaveCompleted.Unbind();
+		return false;
+	}
+	return true;
+}
+
+bool UGameManager::IsSavingGame() const
+{
+	return PendingSaveGame != nullptr;
+}
+
+void UGameManager::OnGameSavedToRecord( bool bSuccess, FGameRecord& Record )
+{
+	USaveGameObject* SaveGameObject = PendingSaveGame;
+	FOnGameSaved OnSaved = PendingSaveCompleted;
+	PendingSaveGame = nullptr;
+	PendingSaveCompleted.Unbind();
+
+	if ( !bSuccess )
+	{
+		OnSaved.ExecuteIfBound( false );
+		return;
+	}
 
-	return UGameplayStatics::SaveGameToSlot( SaveGameObject, SlotName, UserIndex );
+	SaveGameObject->GameRecord = MoveTemp( Record );
+	WriteSaveGameAsync( SaveGameObject, PendingSaveSlotName, PendingSaveUserIndex, OnSaved );
 }
 
 void UGameManager::Init()
@@ -1,7 +1,29 @@
 // @Author Fathurahman <ipat.bogor@gmail.com> @ipatizer
 #include "GamePrivatePCH.h"
+#include "GameStats.h"
 
 DEFINE_LOG_CATEGORY(LogGame)
 DEFINE_LOG_CATEGORY(LogTrace)
 
+DEFINE_STAT( STAT_GameModules_GameTick );
+DEFINE_STAT( STAT_GameModules_ContainerTick );
+DEFINE_STAT( STAT_GameModules_ContainerSimulationTick );
+DEFINE_STAT( STAT_GameModules_TreeTick );
+DEFINE_STAT( STAT_GameModules_TreeSimulationTick );
+DEFINE_STAT( STAT_GameModules_TreeParallelSimulationTick );
+DEFINE_STAT( STAT_GameModules_SaveToRecord );
+DEFINE_STAT( STAT_GameModules_LoadFromRecord );
+DEFINE_STAT( STAT_GameModules_SaveGameIO );
+DEFINE_STAT( STAT_GameModules_SaveGameCompress );
+DEFINE_STAT( STAT_GameModules_SaveGameDecompress );
+DEFINE_STAT( STAT_GameModules_TweenerTick );
+DEFINE_STAT( STAT_GameModules_WidgetTick );
+DEFINE_STAT( STAT_GameModules_DynamicCanvasTick );
+
+DEFINE_STAT( STAT_GameModules_ObjectsTicked );
+DEFINE_STAT( STAT_GameModules_ObjectsSimulationTicked );
+DEFINE_STAT( STAT_GameModules_TweensActive );
+DEFINE_STAT( STAT_GameModules_WidgetsProjected );
+DEFINE_STAT( STAT_GameModules_RecordsSerialized );
+
 IMPLEMENT_GAME_MODULE(FDefaultGameModuleImpl, Game);
\ No newline at end of file
@@ -1,10 +1,39 @@
 // @Author Fathurahman <ipat.bogor@gmail.com> @ipatizer
 #include "GamePrivatePCH.h"
 #include "GameObjectTree.h"
+#include "Util/BlueprintEventCache.h"
+
+/** Blueprint events of UGameObject, in the order of their names in GameObjectEvents. */
+enum EGameObjectEvent
+{
+	GOE_Tick,
+	GOE_SimulationTick,
+	GOE_SimulationTickSynced,
+	GOE_AddedToObjectTree,
+	GOE_RemovedFromObjectTree,
+	GOE_AddedToParent,
+	GOE_RemovedFromParent,
+	GOE_Loaded,
+	GOE_Dispose,
+	GOE_ReturnedToPool,
+};
+
+static FBlueprintEventCache GameObjectEvents( {
+	TEXT("ReceiveTick"),
+	TEXT("ReceiveSimulationTick"),
+	TEXT("ReceiveSimulationTickSynced"),
+	TEXT("ReceiveAddedToObjectTree"),
+	TEXT("ReceiveRemovedFromObjectTree"),
+	TEXT("ReceiveAddedToParent"),
+	TEXT("ReceiveRemovedFromParent"),
+	TEXT("ReceiveLoaded"),
+	TEXT("ReceiveDispose"),
+	TEXT("ReceiveReturnedToPool"),
+} );
 
 FString UGameObject::GetID() const
 {
-	return ID;
+	return ID.IsNone() ? FString() : ID.ToString();
 }
 
 bool UGameObject::IsDescendantOf(UGameObjectContainer* InAncestor) const
@@ -12,6 +41,49 @@ bool UGameObject::IsDescendantOf(UGameObjectContainer* InAncestor) const
 	return InAncestor ? InAncestor->IsAncestorOf((UGameObject*)this) : false;
 }
 
+void UGameObject::SetCanTick( bool bFlag )
+{
+	if ( SetSaveGameProperty( bCanTick, bFlag ) )
+	{
+		if ( UGameObjectTree* ObjectTree = GetObjectTree() )
+		{
+			ObjectTree->RefreshTickRegistration( this );
+		}
+	}
+}
+
+void UGameObject::SetCanSimulationTick( bool bFlag )
+{
+	if ( SetSaveGameProperty( bCanSimulationTick, bFlag ) )
+	{
+		if ( UGameObjectTree* ObjectTree = GetObjectTree() )
+		{
+			ObjectTree->RefreshTickRegistration( this );
+		}
+	}
+}
+
+void UGameObject::SetSimulationTickInterval( FTimespan InInterval )
+{
+	if ( SetSaveGameProperty( SimulationTickInterval, InInterval ) )
+	{
+		if ( UGameObjectTree* ObjectTree = GetObjectTree() )
+		{
+			ObjectTree->RefreshTickRegistration( this );
+		}
+	}
+}
+
+void UGameObject::MarkSaveDirty()
+{
+	if ( UGameObjectTree* ObjectTree = GetObjectTree() )
+	{
+		// The save in progress needs this object as it was before the change.
+		ObjectTree->CaptureForSave( this );
+		ObjectTree->NoteSaveDirty( this );
+	}
+}
+
 UGameObjectContainer* UGameObject::GetParent() const
 {
 	return Parent.Get();
@@ -29,43 +101,122 @@ bool UGameObject::SetParent(UGameObjectContainer* InParent)
 
 UGameObjectTree* UGameObject::GetObjectTree() const
 {
-	UGameObjectContainer* Container = Parent.Get();
-	while ( Container && Container->Parent.IsValid() )
-	{
-		Container = Container->Parent.Get();
-	}
-	return Container ? Cast<UGameObjectTree>( Container ) : nullptr;
+	return OwningTree;
 }
 
 void UGameObject::Tick(float DeltaTime)
 {
-	ReceiveTick( DeltaTime );
+	if ( GameObjectEvents.IsImplemented( this, GOE_Tick ) )
+	{
+		ReceiveTick( DeltaTime );
+	}
 }
 
 void UGameObject::SimulationTick(const FTimespan& Timespan)
 {
-	ReceiveSimulationTick( Timespan );
+	// Blueprint can only run on the game thread, thread safe subtrees never call it so it does not depend on where they are scheduled.
+	if ( !UGameObjectTree::IsSimulatingThreadSafeSubtree() && GameObjectEvents.IsImplemented( this, GOE_SimulationTick ) )
+	{
+		ReceiveSimulationTick( Timespan );
+	}
+}
+
+void UGameObject::OnAddedToObjectTree( UGameObjectTree* ToObjectTree )
+{
+	if ( GameObjectEvents.IsImplemented( this, GOE_AddedToObjectTree ) )
+	{
+		ReceiveAddedToObjectTree( ToObjectTree );
+	}
+}
+
+void UGameObject::OnRemovedFromObjectTree( UGameObjectTree* FromObjectTree )
+{
+	if ( GameObjectEvents.IsImplemented( this, GOE_RemovedFromObjectTree ) )
+	{
+		ReceiveRemovedFromObjectTree( FromObjectTree );
+	}
+}
+
+void UGameObject::OnAddedToParent( UGameObjectContainer* ToParent )
+{
+	if ( GameObjectEvents.IsImplemented( this, GOE_AddedToParent ) )
+	{
+		ReceiveAddedToParent( ToParent );
+	}
+}
+
+void UGameObject::OnRemovedFromParent( UGameObjectContainer* FromParent )
+{
+	if ( GameObjectEvents.IsImplemented( this, GOE_RemovedFromParent ) )
+	{
+		ReceiveRemovedFromParent( FromParent );
+	}
+}
+
+void UGameObject::OnLoaded()
+{
+	if ( GameObjectEvents.IsImplemented( this, GOE_Loaded ) )
+	{
+		ReceiveLoaded();
+	}
+}
+
+void UGameObject::OnDispose()
+{
+	if ( GameObjectEvents.IsImplemented( this, GOE_Dispose ) )
+	{
+		ReceiveDispose();
+	}
+}
+
+void UGameObject::OnSimulationTickSynced( const FTimespan& Timespan )
+{
+	if ( GameObjectEvents.IsImplemented( this, GOE_SimulationTickSynced ) )
+	{
+		ReceiveSimulationTickSynced( Timespan );
+	}
+}
+
+void UGameObject::OnReturnedToPool( UGameObjectTree* Pool )
+{
+	if ( GameObjectEvents.IsImplemented( this, GOE_ReturnedToPool ) )
+	{
+		ReceiveReturnedToPool( Pool );
+	}
 }
 
 void UGameObject::Dispose()
 {
-	if (IsPendingKill() == false)
+	Dispose_Internal( GetObjectTree() );
+}
+
+void UGameObject::Dispose_Internal( UGameObjectTree* InPoolTree )
+{
+	if ( IsPendingKill() || bIsInPool )
 	{
-		if (Parent.IsValid())
-		{
-			Parent->RemoveChild(this, false);
-		}
+		return;
+	}
 
-		OnDispose();
+	if (Parent.IsValid())
+	{
+		Parent->RemoveChild(this, false);
+	}
 
-		MarkPendingKill();
+	if ( bPoolable && InPoolTree && InPoolTree != this && InPoolTree->ReturnToPool( this ) )
+	{
+		return;
 	}
+	UGameObjectTree::UncountActivePooledObject( this );
+
+	OnDispose();
+
+	MarkPendingKill();
 }
 
 
 FString UGameObject::GetIDOrName() const
 {
-	return ID.IsEmpty() ? GetName() : ID;
+	return ID.IsNone() ? GetName() : ID.ToString();
 }
 
 UWorld* UGameObject::GetWorld() const
@@ -0,0 +1,568 @@
+// @Author Fathurahman <ipat.bogor@gmail.com> @ipatizer
+#include "GamePrivatePCH.h"
+#include "Util/GameObjectBenchmarkCommandlet.h"
+#include "Object/GameObjectTree.h"
+#include "Util/ChunkedCompression.h"
+
+//////////////////////////////////////////////////////////////////////////
+// UGameObjectBenchmarkObject
+//////////////////////////////////////////////////////////////////////////
+
+UGameObjectBenchmarkObject::UGameObjectBenchmarkObject( const FObjectInitializer& ObjectInitializer )
+	: Super( ObjectInitializer )
+{
+	bCanTick = true;
+	bCanSimulationTick = true;
+}
+
+void UGameObjectBenchmarkObject::Tick( float DeltaTime )
+{
+	NumTicks++;
+}
+
+void UGameObjectBenchmarkObject::SimulationTick( const FTimespan& Timespan )
+{
+	NumSimulationTicks++;
+}
+
+UGameObjectBenchmarkTarget::UGameObjectBenchmarkTarget( const FObjectInitializer& ObjectInitializer )
+	: Super( ObjectInitializer )
+{
+}
+
+//////////////////////////////////////////////////////////////////////////
+// Measuring
+//////////////////////////////////////////////////////////////////////////
+
+/**
+* Forwards everything to another allocator and counts the allocations.
+* Allocations made by other threads while a benchmark runs are counted too, keep the engine idle.
+*/
+class FGameObjectBenchmarkMalloc : public FMalloc
+{
+public:
+
+	FGameObjectBenchmarkMalloc( FMalloc* InInnerMalloc )
+		: InnerMalloc( InInnerMalloc )
+		, NumAllocations( 0 )
+	{
+	}
+
+	FMalloc* InnerMalloc;
+
+	volatile int64 NumAllocations;
+
+	virtual void* Malloc( SIZE_T Count, uint32 Alignment ) override
+	{
+		FPlatformAtomics::InterlockedIncrement( &NumAllocations );
+		return InnerMalloc->Malloc( Count, Alignment );
+	}
+
+	virtual void* Realloc( void* Original, SIZE_T Count, uint32 Alignment ) override
+	{
+		if ( Count > 0 )
+		{
+			FPlatformAtomics::InterlockedIncrement( &NumAllocations );
+		}
+		return InnerMalloc->Realloc( Original, Count, Alignment );
+	}
+
+	virtual void Free( void* Original ) override { InnerMalloc->Free( Original ); }
+	virtual bool GetAllocationSize( void* Original, SIZE_T& SizeOut ) override { return InnerMalloc->GetAllocationSize( Original, SizeOut ); }
+	virtual bool IsInternallyThreadSafe() const override { return InnerMalloc->IsInternallyThreadSafe(); }
+	virtual bool ValidateHeap() override { return InnerMalloc->ValidateHeap(); }
+	virtual void Trim() override { InnerMalloc->Trim(); }
+	virtual void UpdateStats() override { InnerMalloc->UpdateStats(); }
+	virtual void DumpAllocatorStats( FOutputDevice& Ar ) override { InnerMalloc->DumpAllocatorStats( Ar ); }
+	virtual const TCHAR* GetDescriptiveName() override { return InnerMalloc->GetDescriptiveName(); }
+};
+
+struct FGameObjectBenchmarkResult
+{
+	FString Benchmark;
+	int32 NumObjects;
+	int64 NumOps;
+	double NsPerOp;
+	double AllocationsPerOp;
+
+	/** Size in bytes of what the benchmark has produced, zero for the benchmarks that only measure time. */
+	int64 NumBytes;
+
+	FString GetKey() const { return FString::Printf( TEXT("%s@%d"), *Benchmark, NumObjects ); }
+};
+
+class FGameObjectBenchmark
+{
+public:
+
+	FGameObjectBenchmark( FGameObjectBenchmarkMalloc& InMalloc, int32 InIterations )
+		: CountingMalloc( InMalloc )
+		, Iterations( InIterations )
+	{
+	}
+
+	TArray<FGameObjectBenchmarkResult> Results;
+
+	/** Run all benchmarks on a tree with a number of objects. */
+	void Run( int32 NumObjects );
+
+private:
+
+	FGameObjectBenchmarkMalloc& CountingMalloc;
+
+	int32 Iterations;
+
+	/** Time a function that does a number of operations. */
+	template<typename FuncType>
+	void Measure( const TCHAR* Benchmark, int32 NumObjects, int64 NumOps, const FuncType& Func )
+	{
+		const int64 AllocationsBefore = CountingMalloc.NumAllocations;
+		const uint32 StartCycles = FPlatformTime::Cycles();
+
+		Func();
+
+		const double Seconds = FPlatformTime::ToSeconds( FPlatformTime::Cycles() - StartCycles );
+		const int64 NumAllocations = CountingMalloc.NumAllocations - AllocationsBefore;
+
+		FGameObjectBenchmarkResult Result;
+		Result.Benchmark = Benchmark;
+		Result.NumObjects = NumObjects;
+		Result.NumOps = FMath::Max<int64>( NumOps, 1 );
+		Result.NsPerOp = Seconds * 1e9 / Result.NumOps;
+		Result.AllocationsPerOp = (double) NumAllocations / Result.NumOps;
+		Result.NumBytes = 0;
+		Results.Add( Result );
+
+		UE_LOG( LogGame, Display, TEXT("%-24s %8d objects %12.1f ns/op %8.2f allocs/op"), Benchmark, NumObjects, Result.NsPerOp, Result.AllocationsPerOp );
+	}
+
+	/** Record the size of something a benchmark has produced. */
+	void RecordSize( const TCHAR* Benchmark, int32 NumObjects, int64 NumBytes )
+	{
+		FGameObjectBenchmarkResult Result;
+		Result.Benchmark = Benchmark;
+		Result.NumObjects = NumObjects;
+		Result.NumOps = 1;
+		Result.NsPerOp = 0.0;
+		Result.AllocationsPerOp = 0.0;
+		Result.NumBytes = NumBytes;
+		Results.Add( Result );
+
+		UE_LOG( LogGame, Display, TEXT("%-24s %8d objects %12lld bytes"), Benchmark, NumObjects, NumBytes );
+	}
+};
+
+/** Size of a tree record once it is written the way a save game writes it. */
+static int64 GetSaveGameSize( FGameObjectTreeRecord& TreeRecord )
+{
+	TArray<uint8> Bytes;
+	FMemoryWriter Writer( Bytes, true );
+	FObjectAndNameAsStringProxyArchive Ar( Writer, false );
+	FGameObjectTreeRecord::StaticStruct()->SerializeTaggedProperties( Ar, (uint8*) &TreeRecord, FGameObjectTreeRecord::StaticStruct(), nullptr );
+	return Bytes.Num();
+}
+
+void FGameObjectBenchmark::Run( int32 NumObjects )
+{
+	static const FString CommonTag( TEXT("BenchmarkCommon") );
+	static const FString TargetTag( TEXT("BenchmarkTarget") );
+
+	UGameObjectTree* Tree = NewObject<UGameObjectTree>( GetTransientPackage() );
+	Tree->AddToRoot();
+
+	// Objects are spread over groups of at most 1000 so the recursive finds have a subtree to walk,
+	// the last group is a flat container that holds the objects that are added and removed one by one.
+	const int32 GroupSize = 1000;
+	const int32 NumGroups = FMath::Max( NumObjects / GroupSize - 1, 0 );
+	for ( int32 GroupIndex = 0; GroupIndex < NumGroups; GroupIndex++ )
+	{
+		UGameObjectContainer* Group = Tree->CreateChild<UGameObjectContainer>();
+		Group->SetAllowChildrenToTick( true );
+
+		TArray<UGameObjectBenchmarkObject*> Children;
+		Group->CreateChildren<UGameObjectBenchmarkObject>( Children, UGameObjectBenchmarkObject::StaticClass(), GroupSize - 1 );
+		for ( UGameObjectBenchmarkObject* Child : Children )
+		{
+			Child->AddTag( CommonTag );
+		}
+		Group->CreateChild<UGameObjectBenchmarkTarget>()->AddTag( TargetTag );
+	}
+
+	UGameObjectContainer* Flat = Tree->CreateChild<UGameObjectContainer>();
+	Flat->SetAllowChildrenToTick( true );
+
+	const int32 NumFlatObjects = FMath::Max( NumObjects - NumGroups * GroupSize, 1 );
+	TArray<UGameObject*> FlatObjects;
+	FlatObjects.Reserve( NumFlatObjects );
+	for ( int32 Index = 0; Index < NumFlatObjects - 1; Index++ )
+	{
+		UGameObject* Object = NewObject<UGameObjectBenchmarkObject>( GetTransientPackage() );
+		Object->AddTag( CommonTag );
+		FlatObjects.Add( Object );
+	}
+	UGameObject* FlatTarget = NewObject<UGameObjectBenchmarkTarget>( GetTransientPackage() );
+	FlatTarget->AddTag( TargetTag );
+	FlatObjects.Add( FlatTarget );
+
+	Measure( TEXT("AddChild"), NumObjects, FlatObjects.Num(), [&]()
+	{
+		for ( UGameObject* Object : FlatObjects )
+		{
+			Flat->AddChild( Object );
+		}
+	} );
+
+	TArray<FName> IDs;
+	IDs.Reserve( FlatObjects.Num() );
+	for ( UGameObject* Object : FlatObjects )
+	{
+		IDs.Add( Object->GetIDName() );
+	}
+
+	int32 NumFound = 0;
+	Measure( TEXT("FindChildByID"), NumObjects, IDs.Num(), [&]()
+	{
+		for ( const FName& ID : IDs )
+		{
+			NumFound += Flat->FindChild<UGameObject>( ID ) ? 1 : 0;
+		}
+	} );
+
+	Measure( TEXT("FindChildByClass"), NumObjects, Iterations, [&]()
+	{
+		for ( int32 Index = 0; Index < Iterations; Index++ )
+		{
+			NumFound += Flat->FindChild<UGameObjectBenchmarkTarget>() ? 1 : 0;
+		}
+	} );
+
+	Measure( TEXT("FindChildByTag"), NumObjects, Iterations, [&]()
+	{
+		for ( int32 Index = 0; Index < Iterations; Index++ )
+		{
+			NumFound += Flat->FindChild<UGameObject>( NAME_None, TargetTag ) ? 1 : 0;
+		}
+	} );
+
+	TArray<UGameObjectBenchmarkTarget*> Targets;
+	Measure( TEXT("FindDescendantsByClass"), NumObjects, Iterations, [&]()
+	{
+		for ( int32 Index = 0; Index < Iterations; Index++ )
+		{
+			NumFound += Tree->FindDescendants<UGameObjectBenchmarkTarget>( Targets );
+		}
+	} );
+
+	TArray<UGameObject*> Tagged;
+	Measure( TEXT("FindDescendantsByTag"), NumObjects, Iterations, [&]()
+	{
+		for ( int32 Index = 0; Index < Iterations; Index++ )
+		{
+			NumFound += Tree->FindDescendants<UGameObject>( Tagged, TargetTag );
+		}
+	} );
+
+	// Ticks are measured per object ticked.
+	const int32 NumTickIterations = FMath::Max( Iterations / 10, 1 );
+	Measure( TEXT("Tick"), NumObjects, (int64) NumTickIterations * NumObjects, [&]()
+	{
+		for ( int32 Index = 0; Index < NumTickIterations; Index++ )
+		{
+			Tree->Tick( 1.0f / 60.0f );
+		}
+	} );
+
+	Measure( TEXT("SimulationTick"), NumObjects, (int64) NumTickIterations * NumObjects, [&]()
+	{
+		for ( int32 Index = 0; Index < NumTickIterations; Index++ )
+		{
+			Tree->SimulationTick( FTimespan::FromMinutes( 1.0 ) );
+		}
+	} );
+
+	Measure( TEXT("RemoveChild"), NumObjects, FlatObjects.Num(), [&]()
+	{
+		for ( UGameObject* Object : FlatObjects )
+		{
+			Flat->RemoveChild( Object, false );
+		}
+	} );
+
+	// The flat objects are saved too, so the records hold every object of the tree.
+	Flat->AddChildren( FlatObjects );
+
+	// Saving and loading are measured per object record, in both formats. Loading should stay linear in the number of objects.
+	// They are reported with the number of objects actually in the record, the groups and the flat container included.
+	TArray<UGameObject*> Descendants;
+	Tree->GetDescendants( Descendants );
+	const int32 NumRecordObjects = Descendants.Num();
+
+	for ( bool bPack : { false, true } )
+	{
+		Tree->bPackRecords = bPack;
+
+		FGameObjectTreeRecord TreeRecord;
+		Measure( bPack ? TEXT("SaveToPackedRecord") : TEXT("SaveToRecord"), NumRecordObjects, Descendants.Num(), [&]()
+		{
+			Tree->SaveToRecord( TreeRecord );
+		} );
+
+		Measure( bPack ? TEXT("LoadFromPackedRecord") : TEXT("LoadFromRecord"), NumRecordObjects, Descendants.Num(), [&]()
+		{
+			Tree->LoadFromRecord( TreeRecord );
+		} );
+
+		RecordSize( bPack ? TEXT("PackedRecordSize") : TEXT("RecordSize"), NumRecordObjects, GetSaveGameSize( TreeRecord ) );
+	}
+
+	// Delta saves are measured per changed object, with 2% of the objects changed as between two autosaves. They should not depend on the size of the tree.
+	Descendants.Reset();
+	Tree->GetDescendants( Descendants );
+	if ( Descendants.Num() > 0 )
+	{
+		FGameObjectTreeRecord TreeRecord;
+		Tree->SaveDeltaToRecord( TreeRecord );
+
+		const int32 NumChanged = FMath::Max( Descendants.Num() / 50, 1 );
+		Measure( TEXT("SaveDeltaToRecord"), Descendants.Num(), NumChanged, [&]()
+		{
+			for ( int32 Index = 0; Index < NumChanged; Index++ )
+			{
+				Descendants[ (int64) Index * Descendants.Num() / NumChanged ]->MarkSaveDirty();
+			}
+			Tree->SaveDeltaToRecord( TreeRecord );
+		} );
+
+		Measure( TEXT("LoadFromDeltaRecord"), Descendants.Num(), Descendants.Num(), [&]()
+		{
+			Tree->LoadFromRecord( TreeRecord );
+		} );
+
+		RecordSize( TEXT("DeltaRecordSize"), Descendants.Num(), GetSaveGameSize( TreeRecord ) );
+	}
+
+	// A partial load is measured per object of the record with none of the children loaded, it should only cost the copy of the record.
+	// Loading the deferred children afterwards should cost about as much as a whole load.
+	{
+		FGameObjectTreeRecord TreeRecord;
+		Tree->bPackRecords = true;
+		Tree->SaveToRecord( TreeRecord );
+
+		Descendants.Reset();
+		Tree->GetDescendants( Descendants );
+
+		Measure( TEXT("LoadFromRecordDeferred"), Descendants.Num(), Descendants.Num(), [&]()
+		{
+			Tree->LoadFromRecord( TreeRecord, TArray<FName>() );
+		} );
+
+		Measure( TEXT("LoadAllDeferredSubtrees"), Descendants.Num(), Descendants.Num(), [&]()
+		{
+			Tree->LoadAllDeferredSubtrees();
+		} );
+	}
+
+	// Save game compression is measured per uncompressed byte of a packed record, for each codec.
+	{
+		FGameObjectTreeRecord TreeRecord;
+		Tree->bPackRecords = true;
+		Tree->SaveToRecord( TreeRecord );
+		const TArray<uint8>& Bytes = TreeRecord.PackedData;
+
+		Descendants.Reset();
+		Tree->GetDescendants( Descendants );
+
+		const UEnum* CodecEnum = FindObject<UEnum>( ANY_PACKAGE, TEXT("ESaveGameCompression"), true );
+		for ( int32 CodecIndex = 0; CodecIndex <= (int32) ESaveGameCompression::Gzip; CodecIndex++ )
+		{
+			const ESaveGameCompression Codec = (ESaveGameCompression) CodecIndex;
+			const FString CodecName = CodecEnum ? CodecEnum->GetEnumName( CodecIndex ) : FString::FromInt( CodecIndex );
+
+			TArray<uint8> Compressed;
+			Measure( *( TEXT("Compress") + CodecName ), Descendants.Num(), Bytes.Num(), [&]()
+			{
+				FChunkedCompression::Compress( Codec, Bytes.GetData(), Bytes.Num(), Compressed );
+			} );
+
+			TArray<uint8> Decompressed;
+			Measure( *( TEXT("Decompress") + CodecName ), Descendants.Num(), Bytes.Num(), [&]()
+			{
+				FChunkedCompression::Decompress( Compressed.GetData(), Compressed.Num(), Decompressed );
+			} );
+
+			RecordSize( *( TEXT("CompressedSize") + CodecName ), Descendants.Num(), Compressed.Num() );
+		}
+	}
+
+	UE_LOG( LogGame, Verbose, TEXT("Found %d objects."), NumFound );
+
+	for ( UGameObject* Object : FlatObjects )
+	{
+		Object->Dispose();
+	}
+	Tree->Dispose();
+	Tree->RemoveFromRoot();
+	CollectGarbage( GARBAGE_COLLECTION_KEEPFLAGS );
+}
+
+//////////////////////////////////////////////////////////////////////////
+// Output
+//////////////////////////////////////////////////////////////////////////
+
+static FString ToCSV( const TArray<FGameObjectBenchmarkResult>& Results )
+{
+	FString CSV = TEXT("Benchmark,NumObjects,NumOps,NsPerOp,AllocationsPerOp,NumBytes\n");
+	for ( const FGameObjectBenchmarkResult& Result : Results )
+	{
+		CSV += FString::Printf( TEXT("%s,%d,%lld,%.3f,%.3f,%lld\n"), *Result.Benchmark, Result.NumObjects, Result.NumOps, Result.NsPerOp, Result.AllocationsPerOp, Result.NumBytes );
+	}
+	return CSV;
+}
+
+static FString ToJSON( const TArray<FGameObjectBenchmarkResult>& Results )
+{
+	FString JSON = TEXT("{\n\t\"Results\": [\n");
+	for ( int32 Index = 0; Index < Results.Num(); Index++ )
+	{
+		const FGameObjectBenchmarkResult& Result = Results[Index];
+		JSON += FString::Printf( TEXT("\t\t{ \"Benchmark\": \"%s\", \"NumObjects\": %d, \"NumOps\": %lld, \"NsPerOp\": %.3f, \"AllocationsPerOp\": %.3f, \"NumBytes\": %lld }%s\n"),
+			*Result.Benchmark, Result.NumObjects, Result.NumOps, Result.NsPerOp, Result.AllocationsPerOp, Result.NumBytes, Index + 1 < Results.Num() ? TEXT(",") : TEXT("") );
+	}
+	JSON += TEXT("\t]\n}\n");
+	return JSON;
+}
+
+/** Read the results of a previous run from its CSV. */
+static bool LoadBaseline( const FString& Path, TMap<FString, FGameObjectBenchmarkResult>& OutBaseline )
+{
+	TArray<FString> Lines;
+	if ( !FFileHelper::LoadANSITextFileToStrings( *Path, nullptr, Lines ) )
+	{
+		return false;
+	}
+
+	// The first line is the header.
+	for ( int32 Index = 1; Index < Lines.Num(); Index++ )
+	{
+		TArray<FString> Columns;
+		if ( Lines[Index].ParseIntoArray( Columns, TEXT(","), false ) < 5 )
+		{
+			continue;
+		}
+
+		FGameObjectBenchmarkResult Result;
+		Result.Benchmark = Columns[0];
+		Result.NumObjects = FCString::Atoi( *Columns[1] );
+		Result.NumOps = FCString::Atoi64( *Columns[2] );
+		Result.NsPerOp = FCString::Atod( *Columns[3] );
+		Result.AllocationsPerOp = FCString::Atod( *Columns[4] );
+		Result.NumBytes = Columns.Num() > 5 ? FCString::Atoi64( *Columns[5] ) : 0;
+		OutBaseline.Add( Result.GetKey(), Result );
+	}
+	return true;
+}
+
+//////////////////////////////////////////////////////////////////////////
+// UGameObjectBenchmarkCommandlet
+//////////////////////////////////////////////////////////////////////////
+
+UGameObjectBenchmarkCommandlet::UGameObjectBenchmarkCommandlet( const FObjectInitializer& ObjectInitializer )
+	: Super( ObjectInitializer )
+{
+	IsClient = false;
+	IsServer = false;
+	IsEditor = false;
+	LogToConsole = true;
+}
+
+int32 UGameObjectBenchmarkCommandlet::Main( const FString& Params )
+{
+	TArray<int32> Sizes;
+	FString SizesParam;
+	if ( FParse::Value( *Params, TEXT("Sizes="), SizesParam ) )
+	{
+		TArray<FString> SizeStrings;
+		SizesParam.ParseIntoArray( SizeStrings, TEXT(","), true );
+		for ( const FString& SizeString : SizeStrings )
+		{
+			Sizes.Add( FMath::Max( FCString::Atoi( *SizeString ), 1 ) );
+		}
+	}
+	else
+	{
+		Sizes.Add( 1000 );
+		Sizes.Add( 10000 );
+		Sizes.Add( 100000 );
+		Sizes.Add( 1000000 );
+	}
+
+	int32 Iterations = 100;
+	FParse::Value( *Params, TEXT("Iterations="), Iterations );
+	Iterations = FMath::Max( Iterations, 1 );
+
+	FString OutputPath = FPaths::Combine( *FPaths::GameSavedDir(), TEXT("Benchmarks"), TEXT("GameObjectBenchmark") );
+	FParse::Value( *Params, TEXT("Output="), OutputPath );
+
+	FString BaselinePath;
+	FParse::Value( *Params, TEXT("Baseline="), BaselinePath );
+
+	float MaxRegression = 0.25f;
+	FParse::Value( *Params, TEXT("MaxRegression="), MaxRegression );
+
+	// Count allocations while the benchmarks run.
+	FMalloc* PrevMalloc = GMalloc;
+	FGameObjectBenchmarkMalloc CountingMalloc( PrevMalloc );
+	GMalloc = &CountingMalloc;
+
+	FGameObjectBenchmark Benchmark( CountingMalloc, Iterations );
+	for ( int32 Size : Sizes )
+	{
+		Benchmark.Run( Size );
+	}
+
+	GMalloc = PrevMalloc;
+
+	const TArray<FGameObjectBenchmarkResult>& Results = Benchmark.Results;
+	if ( !FFileHelper::SaveStringToFile( ToCSV( Results ), *( OutputPath + TEXT(".csv") ) )
+		|| !FFileHelper::SaveStringToFile( ToJSON( Results ), *( OutputPath + TEXT(".json") ) ) )
+	{
+		PrintLogError( "Failed to write the results to %s", *OutputPath );
+		return 1;
+	}
+	UE_LOG( LogGame, Display, TEXT("Results written to %s.csv and %s.json"), *OutputPath, *OutputPath );
+
+	if ( BaselinePath.IsEmpty() )
+	{
+		return 0;
+	}
+
+	TMap<FString, FGameObjectBenchmarkResult> Baseline;
+	if ( !LoadBaseline( BaselinePath, Baseline ) )
+	{
+		PrintLogError( "Failed to read the baseline %s", *BaselinePath );
+		return 1;
+	}
+
+	int32 NumRegressions = 0;
+	for ( const FGameObjectBenchmarkResult& Result : Results )
+	{
+		const FGameObjectBenchmarkResult* Base = Baseline.Find( Result.GetKey() );
+		if ( !Base )
+		{
+			continue;
+		}
+
+		// A small absolute slack so that results close to zero do not fail on noise.
+		const bool bSlower = Result.NsPerOp > Base->NsPerOp * ( 1.0 + MaxRegression ) + 1.0;
+		const bool bAllocatesMore = Result.AllocationsPerOp > Base->AllocationsPerOp * ( 1.0 + MaxRegression ) + 0.01;
+		const bool bLarger = Base->NumBytes > 0 && Result.NumBytes > Base->NumBytes * ( 1.0 + MaxRegression );
+		if ( bSlower || bAllocatesMore || bLarger )
+		{
+			PrintLogError( "%s regressed: %.1f ns/op %.2f allocs/op %lld bytes, baseline %.1f ns/op %.2f allocs/op %lld bytes",
+				*Result.GetKey(), Result.NsPerOp, Result.AllocationsPerOp, Result.NumBytes, Base->NsPerOp, Base->AllocationsPerOp, Base->NumBytes );
+			NumRegressions++;
+		}
+	}
+
+	return NumRegressions > 0 ? 1 : 0;
+}
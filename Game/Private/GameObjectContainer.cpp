@@ -2,11 +2,47 @@
 #include "GamePrivatePCH.h"
 #include "GameObjectTree.h"
 #include "GameUtil.h"
+#include "Util/BlueprintEventCache.h"
+#include "GameStats.h"
+
+/** Blueprint events of UGameObjectContainer, in the order of their names in ContainerEvents. */
+enum EGameObjectContainerEvent
+{
+	GOCE_ChildAdded,
+	GOCE_ChildRemoved,
+	GOCE_ChildrenAdded,
+};
+
+static FBlueprintEventCache ContainerEvents( {
+	TEXT("ReceiveChildAdded"),
+	TEXT("ReceiveChildRemoved"),
+	TEXT("ReceiveChildrenAdded"),
+} );
+
+/** 
+* Convert an ID coming from blueprint to a name that can be used to look up a child.
+* @return false if no child can have such ID, which happens when the ID has never been interned.
+*/
+static bool ToLookupID( const FString& InID, FName& OutID )
+{
+	if ( InID.IsEmpty() )
+	{
+		OutID = NAME_None;
+		return true;
+	}
+	OutID = FName( *InID, FNAME_Find );
+	return OutID.IsNone() == false;
+}
+
+static FName ToChildID( const FString& InID )
+{
+	return InID.IsEmpty() ? NAME_None : FName( *InID );
+}
 
 UGameObjectContainer::UGameObjectContainer(const FObjectInitializer& ObjectInitializer)
 	: Super(ObjectInitializer)
+	, NumChildren(0)
 	, bIsChildrenLocked(false)
-	, bIsChildrenDirty(false)
 {
 }
 
@@ -17,23 +53,38 @@ bool UGameObjectContainer::IsAncestorOf(UGameObject* Other) const
 		return false;
 	}
 
+	// Objects in different trees are never related.
+	UGameObjectTree* ObjectTree = GetObjectTree();
+	if ( ObjectTree != Other->GetObjectTree() )
+	{
+		return false;
+	}
+
+	if ( ObjectTree && ObjectTree->HasValidIntervalNumbering() )
+	{
+		return IntervalBegin < Other->IntervalBegin && Other->IntervalEnd <= IntervalEnd;
+	}
+
+	// Only this container's depth can be the depth of the ancestor, so walk up exactly that far.
+	int32 NumSteps = Other->Depth - Depth;
+	if ( NumSteps <= 0 )
+	{
+		return false;
+	}
+
 	UGameObjectContainer* Container = Other->Parent.Get();
-	while (Container)
+	while ( --NumSteps > 0 && Container )
 	{
-		if (Container == this)
-		{
-			return true;
-		}
 		Container = Container->Parent.Get();
 	}
 
-	return false;
+	return Container == this;
 }
 
 
 UGameObject* UGameObjectContainer::BPF_AddChild( UGameObject* InChild, const FString& InID, bool bOverwrite, ESuccess& OutResult )
 {
-	UGameObject* Object = AddChild( InChild, InID, bOverwrite );
+	UGameObject* Object = AddChild( InChild, ToChildID( InID ), bOverwrite );
 	OutResult = GetSuccessEnum( Object != nullptr );
 	return Object;
 }
@@ -41,7 +92,7 @@ UGameObject* UGameObjectContainer::BPF_AddChild( UGameObject* InChild, const FSt
 
 UGameObject* UGameObjectContainer::BPF_CreateChild( TSubclassOf<UGameObject> InClass, const FString& InID, ESuccess& OutResult )
 {
-	UGameObject* Object = CreateChild_Internal( InClass, InID, false );
+	UGameObject* Object = CreateChild_Internal( InClass, ToChildID( InID ), false );
 	OutResult = GetSuccessEnum( Object != nullptr );
 	return Object;
 }
@@ -49,38 +100,43 @@ UGameObject* UGameObjectContainer::BPF_CreateChild( TSubclassOf<UGameObject> InC
 
 UGameObject* UGameObjectContainer::BPF_GetOrCreateChild( TSubclassOf<UGameObject> InClass, const FString& InID )
 {
-	return GetOrCreateChild_Internal( InClass, InID );
+	return GetOrCreateChild_Internal( InClass, ToChildID( InID ) );
 }
 
-UGameObject* UGameObjectContainer::AddChild( UGameObject* InChild, const FString& InID, bool bOverwrite )
+UGameObject* UGameObjectContainer::AddChild( UGameObject* InChild, const FName& InID, bool bOverwrite )
 {
+	// The tree structure is not thread safe, thread safe simulation ticks must not change it.
+	check( IsInGameThread() && !UGameObjectTree::IsSimulatingThreadSafeSubtree() );
+
 	// Check if this new child can actually be added to the child list.
-	if ( !InChild 
-		|| InChild->IsPendingKill() 
-		|| InChild->Parent.Get() == this 
-		|| InChild->IsA( UGameObjectTree::StaticClass() ) 
-		|| this->IsDescendantOf( Cast<UGameObjectContainer>(InChild) ) )
+	if ( !CanAddChild( InChild ) )
 	{
 		return nullptr;
 	}
 
 	// Resolve ID, child's ID must be unique in a container.
-	FString ChildID = InID;
-	if ( ChildID.IsEmpty() )
+	FName ChildID = InID;
+	if ( ChildID.IsNone() )
 	{
 		// ID is not specified, generate a unique ID.
-		GenerateUniqueID( InChild, ChildID );
+		ChildID = GenerateUniqueID( InChild );
 	}
 	else
 	{
-		// ID is specified, check for ID clash.
-		UGameObject** ExistingChild = Children.Find( ChildID );
+		// ID is specified, check for ID clash. A child of the tree that has not been loaded yet holds its ID too.
+		UGameObjectTree* ObjectTree = GetObjectTree();
+		if ( ObjectTree == this )
+		{
+			ObjectTree->LoadDeferredSubtrees( nullptr, ChildID, false );
+		}
+
+		UGameObject* ExistingChild = FindChildByID( ChildID );
 		if ( ExistingChild )
 		{
 			// If bOverwrite is true then overwrite the existing object, else failed.
 			if ( bOverwrite )
 			{
-				RemoveChild( *ExistingChild, true );
+				RemoveChild( ExistingChild, true );
 			}
 			else
 			{
@@ -89,112 +145,254 @@ UGameObject* UGameObjectContainer::AddChild( UGameObject* InChild, const FString
 			}
 		}
 	}
-	InChild->ID = ChildID;
 
+	AttachChild( InChild, ChildID, true );
+
+	// Go ahead and return the new child.
+	return InChild;
+}
+
+bool UGameObjectContainer::CanAddChild( UGameObject* InChild ) const
+{
+	return InChild
+		&& InChild->IsPendingKill() == false
+		&& InChild->bIsInPool == false
+		&& InChild->Parent.Get() != this
+		&& InChild->IsA( UGameObjectTree::StaticClass() ) == false
+		&& this->IsDescendantOf( Cast<UGameObjectContainer>( InChild ) ) == false;
+}
+
+void UGameObjectContainer::AttachChild( UGameObject* InChild, const FName& ChildID, bool bNotify )
+{
 	// Get the  object tree of the new child, to be used later to determine whether to trigger event related to object tree.
 	UGameObjectTree* ChildPrevTree = InChild->GetObjectTree();
+	UGameObjectTree* ChildCurrentTree = GetObjectTree();
 	
 	// Remove the new child from its previous parent.
 	if (UGameObjectContainer* PrevParent = InChild->Parent.Get())
 	{
-		PrevParent->Children.Remove(InChild->GetID());
+		if ( ChildPrevTree )
+		{
+			ChildPrevTree->UnregisterSubtree( InChild );
+		}
+		PrevParent->ReleaseChildSlot(InChild);
+		PrevParent->AdjustTreeEventListeners( -GetTreeEventListenerWeight( InChild ) );
 		InChild->Parent.Reset();
 		PrevParent->OnChildRemoved(InChild);
 		InChild->OnRemovedFromParent(PrevParent);
 	}
+	InChild->ID = ChildID;
 
 	// Add the new child to this container.
 	if ( bIsChildrenLocked )
 	{
-		PendingAddedChildren.Add( InChild );
-		bIsChildrenDirty = true;
+		DeferredChildCommands.Add( FGameObjectChildCommand( EGameObjectChildCommand::Add, InChild, INDEX_NONE ) );
 	}
 	else
 	{
-		Children.Add( ChildID, InChild );
+		AllocateChildSlot( InChild );
 	}
 	InChild->Parent = this;
-	OnChildAdded(InChild);
-	InChild->OnAddedToParent(this);
+	AdjustTreeEventListeners( SetObjectTreeAndDepth( InChild, ChildCurrentTree, Depth + 1 ) );
+	if ( ChildPrevTree )
+	{
+		ChildPrevTree->InvalidateIntervalNumbering();
+	}
+
+	// Register the new child and its descendants to the tick lists of the object tree.
+	if ( ChildCurrentTree )
+	{
+		ChildCurrentTree->InvalidateIntervalNumbering();
+		ChildCurrentTree->RegisterSubtree( InChild );
+	}
+
+	// Batched adds skip the per-child events of the parent, the trees are told about the move either way.
+	if ( bNotify )
+	{
+		OnChildAdded(InChild);
+		InChild->OnAddedToParent(this);
+	}
 
 	// Trigger added to tree on the new child if necessary.
-	UGameObjectTree* ChildCurrentTree = GetObjectTree();
 	if ( ChildPrevTree != ChildCurrentTree )
 	{
 		if ( ChildPrevTree )
 		{
-			InChild->OnRemovedFromObjectTree( ChildPrevTree );
+			ChildPrevTree->NotifySubtreeRemoved( InChild );
 		}
 		if ( ChildCurrentTree )
 		{
-			InChild->OnAddedToObjectTree( ChildCurrentTree );
+			ChildCurrentTree->NotifySubtreeAdded( InChild );
 		}		
 	}
+}
+
+int32 UGameObjectContainer::AddChildren( const TArray<UGameObject*>& InChildren, bool bNotifyEach )
+{
+	check( IsInGameThread() && !UGameObjectTree::IsSimulatingThreadSafeSubtree() );
 
+	const int32 NumNewSlots = FMath::Max( InChildren.Num() - FreeChildSlots.Num(), 0 );
+	ChildSlots.Reserve( ChildSlots.Num() + NumNewSlots );
+	ChildSlotsByID.Reserve( NumChildren + InChildren.Num() );
 
-	// Go ahead and return the new child.
-	return InChild;
+	TArray<UGameObject*> AddedChildren;
+	AddedChildren.Reserve( InChildren.Num() );
+
+	for ( UGameObject* Child : InChildren )
+	{
+		// The same child might be listed twice.
+		if ( CanAddChild( Child ) )
+		{
+			AttachChild( Child, GenerateUniqueID( Child ), bNotifyEach );
+			AddedChildren.Add( Child );
+		}
+	}
+
+	if ( AddedChildren.Num() > 0 )
+	{
+		OnChildrenAdded( AddedChildren );
+	}
+	return AddedChildren.Num();
+}
+
+int32 UGameObjectContainer::CreateChildren_Internal( UClass* InClass, int32 InCount, TArray<UGameObject*>& OutChildren, bool bNotifyEach )
+{
+	OutChildren.Reset();
+	if ( !InClass || InCount <= 0 )
+	{
+		return 0;
+	}
+
+	UGameObjectTree* ObjectTree = GetObjectTree();
+	OutChildren.Reserve( InCount );
+	for ( int32 Index = 0; Index < InCount; Index++ )
+	{
+		OutChildren.Add( CreateGameObject<UGameObject>( InClass, ObjectTree ) );
+	}
+
+	AddChildren( OutChildren, bNotifyEach );
+
+	// Only keep the children that have been added, the others go back to the pool they may have come from or are disposed.
+	int32 NumAdded = 0;
+	for ( UGameObject* Child : OutChildren )
+	{
+		if ( Child && Child->GetParent() == this )
+		{
+			OutChildren[NumAdded++] = Child;
+		}
+		else if ( Child )
+		{
+			Child->Dispose_Internal( ObjectTree );
+		}
+	}
+	OutChildren.SetNum( NumAdded, false );
+	return NumAdded;
+}
+
+void UGameObjectContainer::BPF_CreateChildren( TSubclassOf<UGameObject> InClass, int32 InCount, bool bNotifyEach, TArray<UGameObject*>& OutChildren )
+{
+	CreateChildren_Internal( InClass, InCount, OutChildren, bNotifyEach );
 }
 
 void UGameObjectContainer::RemoveChild(UGameObject* InChild, bool bDispose /* = true */)
 {
+	check( IsInGameThread() && !UGameObjectTree::IsSimulatingThreadSafeSubtree() );
+
 	// Sanity check.
 	if ( !InChild || InChild->IsPendingKill() || InChild->Parent.Get() != this )
 	{
 		return;
 	}
 
-	// Remove the child from this container
-	if ( bIsChildrenLocked )
+	UGameObjectTree* ObjectTree = GetObjectTree();
+	if ( ObjectTree )
 	{
-		bIsChildrenDirty = true;
+		ObjectTree->UnregisterSubtree( InChild );
 	}
-	else
-	{
-		Children.Remove( InChild->ID );
-	}	
+
+	// Remove the child from this container, while the children are locked the slot is only freed when they are unlocked.
+	ReleaseChildSlot( InChild );
+	AdjustTreeEventListeners( -GetTreeEventListenerWeight( InChild ) );
 	InChild->Parent.Reset();
+	SetObjectTreeAndDepth( InChild, nullptr, 0 );
+	if ( ObjectTree )
+	{
+		ObjectTree->InvalidateIntervalNumbering();
+	}
 	OnChildRemoved(InChild);
 	InChild->OnRemovedFromParent(this);
 
 	// Trigger removed from object tree if this container is attached to object tree.
-	if ( UGameObjectTree* ObjectTree = GetObjectTree() )
+	if ( ObjectTree )
 	{
-		InChild->OnRemovedFromObjectTree( ObjectTree );
+		ObjectTree->NotifySubtreeRemoved( InChild );
 	}
 
-	// If dispose is specified then dispose the child.
+	// If dispose is specified then dispose the child, poolable children go back to the pool of the tree they have just left.
 	if (bDispose)
 	{
-		InChild->Dispose();
+		InChild->Dispose_Internal( ObjectTree );
 	}
 }
 
 
 void UGameObjectContainer::RemoveChildren(bool bDispose /*= true*/)
 {
-	for ( FGameObjectPair& Pair: Children)
-	{
-		UGameObject* Child = Pair.Value;
+	check( IsInGameThread() && !UGameObjectTree::IsSimulatingThreadSafeSubtree() );
 
+	UGameObjectTree* ObjectTree = GetObjectTree();
+
+	auto RemoveOne = [this, ObjectTree, bDispose]( UGameObject* Child )
+	{
+		if ( ObjectTree )
+		{
+			ObjectTree->UnregisterSubtree( Child );
+		}
+		ReleaseChildSlot( Child );
+		AdjustTreeEventListeners( -GetTreeEventListenerWeight( Child ) );
 		Child->Parent.Reset();
+		SetObjectTreeAndDepth( Child, nullptr, 0 );
+		if ( ObjectTree )
+		{
+			ObjectTree->InvalidateIntervalNumbering();
+		}
 
 		OnChildRemoved(Child);
 		Child->OnRemovedFromParent(this);
 
+		if ( ObjectTree )
+		{
+			ObjectTree->NotifySubtreeRemoved( Child );
+		}
+
 		if (bDispose)
 		{
-			Child->Dispose();
+			Child->Dispose_Internal( ObjectTree );
+		}
+	};
+
+	for ( int32 Index = 0; Index < ChildSlots.Num(); Index++ )
+	{
+		if ( UGameObject* Child = ChildSlots[Index].Object )
+		{
+			RemoveOne( Child );
 		}
 	}
 
-	if ( bIsChildrenLocked )
+	// Children added while the children are locked do not have a slot yet.
+	for ( int32 Index = 0; Index < DeferredChildCommands.Num(); Index++ )
 	{
-		bIsChildrenDirty = true;
+		if ( UGameObject* Child = GetDeferredChild( DeferredChildCommands[Index] ) )
+		{
+			RemoveOne( Child );
+		}
 	}
-	else
+
+	// The children of the tree that have not been loaded yet go away with the others, they are not saved anymore.
+	if ( ObjectTree == this && ObjectTree->GetNumDeferredSubtrees() > 0 )
 	{
-		Children.Empty();
+		ObjectTree->ResetDeferredSubtrees();
+		ObjectTree->NoteSaveChildrenChanged( this );
 	}
 }
 
@@ -203,16 +401,43 @@ void UGameObjectContainer::GetChildren( TArray<UGameObject*>& OutChildren ) cons
 	FindChildren_Internal( nullptr, TEXT(""), OutChildren, false );
 }
 
+int32 UGameObjectContainer::GetNumChildren() const
+{
+	return NumChildren;
+}
+
+FGameObjectHandle UGameObjectContainer::GetChildHandle( const UGameObject* InChild ) const
+{
+	if ( !InChild || InChild->Parent.Get() != this || !ChildSlots.IsValidIndex( InChild->SlotIndex ) )
+	{
+		return FGameObjectHandle();
+	}
+	const FGameObjectSlot& Slot = ChildSlots[InChild->SlotIndex];
+	return Slot.Object == InChild ? FGameObjectHandle( InChild->SlotIndex, Slot.Generation ) : FGameObjectHandle();
+}
+
+UGameObject* UGameObjectContainer::ResolveChildHandle( const FGameObjectHandle& Handle ) const
+{
+	if ( !ChildSlots.IsValidIndex( Handle.Index ) )
+	{
+		return nullptr;
+	}
+	const FGameObjectSlot& Slot = ChildSlots[Handle.Index];
+	return Slot.Generation == Handle.Generation ? Slot.Object : nullptr;
+}
+
 
 UGameObject* UGameObjectContainer::BPF_FindChild( TSubclassOf<UGameObject> InClass, const FString& InID, const FString& InTag ) const
 {
-	return FindChild_Internal( InClass, InID, InTag, false );
+	FName ID;
+	return ToLookupID( InID, ID ) ? FindChild_Internal( InClass, ID, InTag, false ) : nullptr;
 }
 
 
 UGameObject* UGameObjectContainer::BPF_FindChildEx( TSubclassOf<UGameObject> InClass, const FString& InID, const FString& InTag, EFindResult& OutResult ) const
 {
-	UGameObject* Child = FindChild_Internal( InClass, InID, InTag, false );
+	FName ID;
+	UGameObject* Child = ToLookupID( InID, ID ) ? FindChild_Internal( InClass, ID, InTag, false ) : nullptr;
 	OutResult = GetFindResultEnum( Child != nullptr );
 	return Child;
 }
@@ -239,13 +464,15 @@ void UGameObjectContainer::GetDescendants( TArray<UGameObject*>& OutDescendants
 
 UGameObject* UGameObjectContainer::BPF_FindDescendant( TSubclassOf<UGameObject> InClass, const FString& InID, const FString& InTag ) const
 {
-	return FindChild_Internal( InClass, InID, InTag, true );
+	FName ID;
+	return ToLookupID( InID, ID ) ? FindChild_Internal( InClass, ID, InTag, true ) : nullptr;
 }
 
 
 UGameObject* UGameObjectContainer::BPF_FindDescendantEx( TSubclassOf<UGameObject> InClass, const FString& InID, const FString& InTag, EFindResult& OutResult ) const
 {
-	UGameObject* Object = FindChild_Internal( InClass, InID, InTag, true );
+	FName ID;
+	UGameObject* Object = ToLookupID( InID, ID ) ? FindChild_Internal( InClass, ID, InTag, true ) : nullptr;
 	OutResult = GetFindResultEnum( Object != nullptr );
 	return Object;
 }
@@ -263,19 +490,33 @@ void UGameObjectContainer::BPF_FindDescendantsEx( TSubclassOf<UGameObject> InCla
 	OutResult = GetFindResultEnum( Num > 0 );
 }
 
+void UGameObjectContainer::SetAllowChildrenToTick( bool bFlag )
+{
+	if ( SetSaveGameProperty( bAllowChildrenToTick, bFlag ) )
+	{
+		if ( UGameObjectTree* ObjectTree = GetObjectTree() )
+		{
+			ObjectTree->RefreshTickRegistration( this );
+		}
+	}
+}
+
 void UGameObjectContainer::Tick(float DeltaTime)
 {
 	Super::Tick( DeltaTime );
 
-	if (bAllowChildrenToTick)
+	if ( bAllowChildrenToTick && !GetObjectTree() )
 	{
+		SCOPE_CYCLE_COUNTER( STAT_GameModules_ContainerTick );
+
 		bool bLockingChildren = LockChildren();
 		
-		for (FGameObjectPair& Pair : Children )
+		for ( const FGameObjectSlot& Slot : ChildSlots )
 		{
-			UGameObject* Child = Pair.Value;
-			if ( Child->bCanTick && Child->GetParent() == this && Child->IsPendingKill() == false )
+			UGameObject* Child = Slot.Object;
+			if ( Child && Child->bCanTick && Child->GetParent() == this && Child->IsPendingKill() == false )
 			{
+				INC_DWORD_STAT( STAT_GameModules_ObjectsTicked );
 				Child->Tick(DeltaTime);
 			}
 		}
@@ -291,15 +532,18 @@ void UGameObjectContainer::SimulationTick(const FTimespan& Timespan)
 {
 	Super::SimulationTick( Timespan );
 
-	if (bAllowChildrenToTick)
+	if ( bAllowChildrenToTick && !GetObjectTree() )
 	{
+		SCOPE_CYCLE_COUNTER( STAT_GameModules_ContainerSimulationTick );
+
 		bool bLockingChildren = LockChildren();
 
-		for ( FGameObjectPair& Pair : Children )
+		for ( const FGameObjectSlot& Slot : ChildSlots )
 		{
-			UGameObject* Child = Pair.Value;
-			if ( Child->bCanSimulationTick && Child->GetParent() == this && Child->IsPendingKill() == false )
+			UGameObject* Child = Slot.Object;
+			if ( Child && Child->bCanSimulationTick && Child->GetParent() == this && Child->IsPendingKill() == false )
 			{
+				INC_DWORD_STAT( STAT_GameModules_ObjectsSimulationTicked );
 				Child->SimulationTick(Timespan);
 			}
 		}
@@ -312,110 +556,103 @@ void UGameObjectContainer::SimulationTick(const FTimespan& Timespan)
 }
 
 
-void UGameObjectContainer::OnAddedToObjectTree( UGameObjectTree* ToObjectTree )
+SIZE_T UGameObjectContainer::GetResourceSize( EResourceSizeMode::Type Mode )
 {
-	Super::OnAddedToObjectTree( ToObjectTree );
-
-	bool bLockingChildren = LockChildren();
+	// Only the members that are not properties, the properties are counted by memory counting archives.
+	return Super::GetResourceSize( Mode ) 
+		+ FreeChildSlots.GetAllocatedSize() 
+		+ ChildSlotsByID.GetAllocatedSize() 
+		+ NextUniqueIDSuffixes.GetAllocatedSize();
+}
 
-	for ( FGameObjectPair& Pair : Children )
+void UGameObjectContainer::OnChildAdded( UGameObject* Child )
+{
+	if ( ContainerEvents.IsImplemented( this, GOCE_ChildAdded ) )
 	{
-		UGameObject* Child = Pair.Value;
-		if ( Child->GetParent() == this && Child->IsPendingKill() == false )
-		{
-			Child->OnAddedToObjectTree( ToObjectTree );
-		}
+		ReceiveChildAdded( Child );
 	}
+}
 
-	for ( UGameObject* Child : PendingAddedChildren )
+void UGameObjectContainer::OnChildRemoved( UGameObject* Child )
+{
+	if ( ContainerEvents.IsImplemented( this, GOCE_ChildRemoved ) )
 	{
-		if ( Child->GetParent() == this && Child->IsPendingKill() == false )
-		{
-			Child->OnAddedToObjectTree( ToObjectTree );
-		}
+		ReceiveChildRemoved( Child );
 	}
+}
 
-	if ( bLockingChildren )
+void UGameObjectContainer::OnChildrenAdded( const TArray<UGameObject*>& Children )
+{
+	if ( ContainerEvents.IsImplemented( this, GOCE_ChildrenAdded ) )
 	{
-		UnlockChildren();
+		ReceiveChildrenAdded( Children );
 	}
 }
 
-
-void UGameObjectContainer::OnRemovedFromObjectTree( UGameObjectTree* FromObjectTree )
+void UGameObjectContainer::OnDispose()
 {
-	Super::OnRemovedFromObjectTree( FromObjectTree );
-
-	bool bLockingChildren = LockChildren();
+	Super::OnDispose();
 
-	for ( FGameObjectPair& Pair : Children )
-	{
-		UGameObject* Child = Pair.Value;
-		if ( Child->GetParent() == this && Child->IsPendingKill() == false )
-		{
-			Child->OnRemovedFromObjectTree( FromObjectTree );
-		}
-	}
+	DisposeChildren( nullptr );
+}
 
-	for ( UGameObject* Child : PendingAddedChildren )
-	{
-		if ( Child->GetParent() == this && Child->IsPendingKill() == false )
-		{
-			Child->OnRemovedFromObjectTree( FromObjectTree );
-		}
-	}
+void UGameObjectContainer::OnReturnedToPool( UGameObjectTree* Pool )
+{
+	DisposeChildren( Pool );
 
-	if ( bLockingChildren )
-	{
-		UnlockChildren();
-	}
+	Super::OnReturnedToPool( Pool );
 }
 
-void UGameObjectContainer::OnDispose()
+void UGameObjectContainer::DisposeChildren( UGameObjectTree* InPoolTree )
 {
-	Super::OnDispose();
-
-	for ( FGameObjectPair& Pair : Children )
+	for ( FGameObjectSlot& Slot : ChildSlots )
 	{
-		UGameObject* Child = Pair.Value;
-		if ( Child->GetParent() == this )
+		UGameObject* Child = Slot.Object;
+		if ( Child && Child->GetParent() == this )
 		{
+			Child->SlotIndex = INDEX_NONE;
 			Child->Parent.Reset();
-			Child->Dispose();
+			Child->OwningTree = nullptr;
+			Child->Dispose_Internal( InPoolTree );
 		}
 	}
-	Children.Empty();	
+	ChildSlots.Empty();
+	FreeChildSlots.Empty();
+	ChildSlotsByID.Empty();
+	NumChildren = 0;
 
-	for ( UGameObject* Child : PendingAddedChildren )
+	TArray<FGameObjectChildCommand> Commands = MoveTemp( DeferredChildCommands );
+	for ( const FGameObjectChildCommand& Command : Commands )
 	{
-		if ( Child->GetParent() == this )
+		if ( UGameObject* Child = GetDeferredChild( Command ) )
 		{
 			Child->Parent.Reset();
-			Child->Dispose();
+			Child->OwningTree = nullptr;
+			Child->Dispose_Internal( InPoolTree );
 		}
 	}
-	PendingAddedChildren.Empty();
 }
 
-UGameObject* UGameObjectContainer::CreateChild_Internal( UClass* InClass, const FString& InID, bool bOverwrite )
+UGameObject* UGameObjectContainer::CreateChild_Internal( UClass* InClass, const FName& InID, bool bOverwrite )
 {
 	if ( !InClass )
 	{
 		return nullptr;
 	}
 
-	UGameObject* Object = CreateGameObject<UGameObject>( InClass );
+	UGameObjectTree* ObjectTree = GetObjectTree();
+	UGameObject* Object = CreateGameObject<UGameObject>( InClass, ObjectTree );
 	
 	if ( AddChild( Object, InID, bOverwrite ) == nullptr )
 	{
-		Object->Dispose();
+		Object->Dispose_Internal( ObjectTree );
 		Object = nullptr;
 	}
 	
 	return Object;
 }
 
-UGameObject* UGameObjectContainer::GetOrCreateChild_Internal( UClass* InClass, const FString& InID )
+UGameObject* UGameObjectContainer::GetOrCreateChild_Internal( UClass* InClass, const FName& InID )
 {
 	if ( !InClass )
 	{
@@ -430,223 +667,231 @@ UGameObject* UGameObjectContainer::GetOrCreateChild_Internal( UClass* InClass, c
 	return Object;	
 }
 
-UGameObject* UGameObjectContainer::FindChild_Internal( UClass* InClass, const FString& InID, const FString& InTag, bool bRecursive ) const
+UGameObject* UGameObjectContainer::FindChild_Internal( UClass* InClass, const FName& InID, const FString& InTag, bool bRecursive ) const
 {
-	if ( Children.Num() == 0 )
+	UGameObjectTree* ObjectTree = GetObjectTree();
+
+	// The children of the tree that have not been loaded yet are loaded when they are looked for, on the game thread only.
+	if ( ObjectTree == this && IsInGameThread() && ObjectTree->DeferredSubtrees.Num() > 0 )
 	{
-		return nullptr;
+		ObjectTree->LoadDeferredSubtrees( InClass, InID, bRecursive );
 	}
 
-	bool bIsClassSpecified = ( InClass != nullptr ) || (InClass == UGameObject::StaticClass());
-	bool bIsIDSpecified = !InID.IsEmpty();
-	bool bIsTagSpecified = !InTag.IsEmpty();
+	if ( bRecursive && InClass && InID.IsNone() && ObjectTree )
+	{
+		return ObjectTree->FindObjectByClass( InClass, this, InTag );
+	}
 
-	if ( !bIsClassSpecified && !bIsIDSpecified && !bIsTagSpecified )
+	if ( NumChildren == 0 && DeferredChildCommands.Num() == 0 )
 	{
-		UGameObject* Object = Children.CreateConstIterator().Value();
-		return Object;
+		return nullptr;
 	}
-	else if ( bIsIDSpecified )
+
+	const bool bIsClassSpecified = ( InClass != nullptr );
+	const bool bIsIDSpecified = !InID.IsNone();
+	const bool bIsTagSpecified = !InTag.IsEmpty();
+
+	// Look the tag up once, a tag that has never been interned can not be had by any object.
+	const int32 TagIndex = bIsTagSpecified ? FGameTagTable::Get().Find( InTag ) : INDEX_NONE;
+	if ( bIsTagSpecified && TagIndex == INDEX_NONE )
 	{
-		UGameObject * const * pObject = Children.Find( InID );
-		if ( !pObject )
-		{
-			return nullptr;
-		}
-		UGameObject* Object = *pObject;
-		if ( !Object 
-			 || ( bIsClassSpecified && Object->IsA(InClass) == false )
-			 || ( bIsTagSpecified && Object->HasTag( InTag ) == false ) )
-		{
-			return nullptr;
-		}
-		return Object;
+		return nullptr;
 	}
-	else 
+
+	auto Matches = [=]( UGameObject* Object )
 	{
-		for ( const FGameObjectPair& Pair : Children )
-		{
-			UGameObject* Object = Pair.Value;
-			if ( Object->GetParent() != this || Object->IsPendingKill() )
-			{
-				continue;
-			}
+		return ( !bIsClassSpecified || Object->IsA( InClass ) )
+			&& ( !bIsIDSpecified || Object->ID == InID )
+			&& ( !bIsTagSpecified || Object->HasTag( TagIndex ) );
+	};
 
-			if ( bIsClassSpecified && Object->IsA( InClass ) == false )
-			{
-				continue;
-			}
-			if ( bIsTagSpecified && Object->HasTag(InTag) == false )
-			{
-				continue;
-			}
-			return Object;
+	// The ID of a child is indexed.
+	if ( bIsIDSpecified )
+	{
+		UGameObject* Child = FindChildByID( InID );
+		if ( Child && Matches( Child ) )
+		{
+			return Child;
 		}
-
-		for ( UGameObject* Object : PendingAddedChildren )
+		if ( bRecursive == false )
 		{
-			if ( Object->GetParent() != this || Object->IsPendingKill() )
-			{
-				continue;
-			}
-			if ( bIsClassSpecified && Object->IsA( InClass ) == false )
-			{
-				continue;
-			}
-			if ( bIsTagSpecified && Object->HasTag(InTag) == false )
-			{
-				continue;
-			}
-			return Object;
+			return nullptr;
 		}
 	}
 
-	// At this point, there is no immediate child that meets the criteria, 
-	// if recursive is not specified then this is the end.
-	if ( bRecursive == false )
+	UGameObject* FoundObject = nullptr;
+	ForEachDescendant( Matches, [&FoundObject]( UGameObject* Object )
 	{
-		return nullptr;
-	}
+		FoundObject = Object;
+		return false;
+	}, FGameObjectTraversalOptions( 1 ) );
 
-	// Recursive
-	for ( const FGameObjectPair& Pair : Children )
+	if ( FoundObject || bRecursive == false )
 	{
-		if ( UGameObjectContainer* Container = Cast<UGameObjectContainer>( Pair.Value ) )
-		{
-			if ( Container->GetParent() != this || Container->IsPendingKill() )
-			{
-				continue;
-			}
-			if ( UGameObject* Object = Container->FindChild_Internal(InClass, InID, InTag, true ) )
-			{
-				return Object;
-			}
-		}
+		return FoundObject;
 	}
-	for ( UGameObject* PendingObject : PendingAddedChildren )
+
+	// The children come first, then the descendants in depth first order, the same order as the lookups in the class index.
+	ForEachDescendant( Matches, [&FoundObject]( UGameObject* Object )
 	{
-		if ( UGameObjectContainer* Container = Cast<UGameObjectContainer>( PendingObject ) )
-		{
-			if ( Container->GetParent() != this || Container->IsPendingKill() )
-			{
-				continue;
-			}
-			if ( UGameObject* Object = Container->FindChild_Internal(InClass, InID, InTag, true ) )
-			{
-				return Object;
-			}
-		}
-	}
+		FoundObject = Object;
+		return false;
+	} );
 
-	// Nope, nothing ...
-	return nullptr;
+	return FoundObject;
 }
 
 int32 UGameObjectContainer::FindChildren_Internal( UClass* InClass, const FString& InTag, TArray<UGameObject*>& OutObjects, bool bRecursive ) const
 {
 	OutObjects.Empty();
 
-	if ( Children.Num() == 0 )
+	UGameObjectTree* ObjectTree = GetObjectTree();
+
+	// The same children that FindChild would load are loaded first, so both find the same objects.
+	if ( ObjectTree == this && IsInGameThread() && ObjectTree->DeferredSubtrees.Num() > 0 )
+	{
+		ObjectTree->LoadDeferredSubtrees( InClass, NAME_None, bRecursive );
+	}
+
+	// Descendants of a class are looked up in the class index of the object tree instead of visiting every descendant.
+	if ( bRecursive && InClass && ObjectTree )
+	{
+		return ObjectTree->FindObjectsByClass( InClass, this, InTag, OutObjects );
+	}
+
+	if ( NumChildren == 0 && DeferredChildCommands.Num() == 0 )
 	{
 		return 0;
 	}
 
-	bool bIsClassSpecified = ( InClass != nullptr ) || (InClass == UGameObject::StaticClass());
-	bool bIsTagSpecified = !InTag.IsEmpty();
+	const bool bIsClassSpecified = ( InClass != nullptr );
+	const bool bIsTagSpecified = !InTag.IsEmpty();
+
+	// Look the tag up once, a tag that has never been interned can not be had by any object.
+	const int32 TagIndex = bIsTagSpecified ? FGameTagTable::Get().Find( InTag ) : INDEX_NONE;
+	if ( bIsTagSpecified && TagIndex == INDEX_NONE )
+	{
+		return 0;
+	}
 
-	if ( !bIsClassSpecified && !bIsTagSpecified )
+	if ( bRecursive == false )
 	{
-		Children.GenerateValueArray( OutObjects );
+		OutObjects.Reserve( NumChildren );
 	}
-	else 
+
+	ForEachDescendant( [=]( UGameObject* Object )
 	{
-		for ( const FGameObjectPair& Pair : Children )
-		{
-			UGameObject* Object = Pair.Value;
-			if ( Object->GetParent() != this || Object->IsPendingKill() )
-			{
-				continue;
-			}
+		return ( !bIsClassSpecified || Object->IsA( InClass ) )
+			&& ( !bIsTagSpecified || Object->HasTag( TagIndex ) );
+	}, 
+	[&OutObjects]( UGameObject* Object )
+	{
+		OutObjects.Add( Object );
+		return true;
+	}, FGameObjectTraversalOptions( bRecursive ? 0 : 1 ) );
 
-			if ( bIsClassSpecified && Object->IsA( InClass ) == false )
-			{
-				continue;
-			}
-			if ( bIsTagSpecified && Object->HasTag(InTag) == false )
-			{
-				continue;
-			}
-			OutObjects.Add( Object );
-		}
+	return OutObjects.Num();
+}
 
-		for ( UGameObject* Object : PendingAddedChildren )
-		{
-			if ( Object->GetParent() != this || Object->IsPendingKill() )
-			{
-				continue;
-			}
-			if ( bIsClassSpecified && Object->IsA( InClass ) == false )
-			{
-				continue;
-			}
-			if ( bIsTagSpecified && Object->HasTag(InTag) == false )
-			{
-				continue;
-			}
-			OutObjects.Add( Object );
-		}
+FName UGameObjectContainer::GenerateUniqueID( UObject* Object )
+{
+	// The suffix is stored as the name's number so no new string is interned, 
+	// and since the suffix only moves forward the loop only skips IDs that were specified manually.
+	const FName BaseID = Object->GetClass()->GetFName();
+	int32& Suffix = NextUniqueIDSuffixes.FindOrAdd( BaseID );
+
+	// The children of the tree that have not been loaded yet keep their IDs.
+	const UGameObjectTree* ObjectTree = GetObjectTree();
+	const bool bHasDeferredChildren = ( ObjectTree == this && ObjectTree->GetNumDeferredSubtrees() > 0 );
+
+	FName ID;
+	do 
+	{
+		ID = FName( BaseID, NAME_EXTERNAL_TO_INTERNAL( Suffix ) );
+		Suffix++;
 	}
+	while( FindChildByID( ID ) || ( bHasDeferredChildren && ObjectTree->IsSubtreeDeferred( ID ) ) );
 
-	// if recursive is not specified then this is the end.
-	if ( bRecursive == false )
+	return ID;
+}
+
+UGameObject* UGameObjectContainer::FindChildByID( const FName& InID ) const
+{
+	if ( const int32* pSlotIndex = ChildSlotsByID.Find( InID ) )
 	{
-		return OutObjects.Num();
+		return ChildSlots[*pSlotIndex].Object;
 	}
 
-	// Recursive
-	for ( const FGameObjectPair& Pair : Children )
+	// The child might have been added while the children are locked.
+	for ( const FGameObjectChildCommand& Command : DeferredChildCommands )
 	{
-		if ( UGameObjectContainer* Container = Cast<UGameObjectContainer>( Pair.Value ) )
+		UGameObject* Child = GetDeferredChild( Command );
+		if ( Child && Child->ID == InID )
 		{
-			if ( Container->GetParent() != this || Container->IsPendingKill() )
-			{
-				continue;
-			}
-			TArray<UGameObject*> Objects;
-			Container->FindChildren_Internal( InClass, InTag, Objects, true );
-			OutObjects.Append( Objects );
+			return Child;
 		}
 	}
-	for ( UGameObject* PendingObject : PendingAddedChildren )
+	return nullptr;
+}
+
+void UGameObjectContainer::AllocateChildSlot( UGameObject* InChild )
+{
+	int32 Index;
+	if ( FreeChildSlots.Num() > 0 )
 	{
-		if ( UGameObjectContainer* Container = Cast<UGameObjectContainer>( PendingObject ) )
-		{
-			if ( Container->GetParent() != this || Container->IsPendingKill() )
-			{
-				continue;
-			}
-			TArray<UGameObject*> Objects;
-			Container->FindChildren_Internal( InClass, InTag, Objects, true );
-			OutObjects.Append( Objects );
-		}
+		Index = FreeChildSlots.Pop( false );
+	}
+	else
+	{
+		Index = ChildSlots.AddDefaulted();
 	}
 
-	// Done
-	return OutObjects.Num();
+	ChildSlots[Index].Object = InChild;
+	InChild->SlotIndex = Index;
+	ChildSlotsByID.Add( InChild->ID, Index );
+	NumChildren++;
+
+	if ( UGameObjectTree* ObjectTree = GetObjectTree() )
+	{
+		ObjectTree->NoteSaveChildrenChanged( this );
+	}
 }
 
-void UGameObjectContainer::GenerateUniqueID( UObject* Object, FString& OutID )
+void UGameObjectContainer::ReleaseChildSlot( UGameObject* InChild )
 {
-	FString BaseID;
-	Object->GetName( BaseID );
+	const int32 Index = InChild->SlotIndex;
+	if ( !ChildSlots.IsValidIndex( Index ) || ChildSlots[Index].Object != InChild )
+	{
+		// Not in a slot, it has been added while the children are locked.
+		CancelDeferredAdd( InChild );
+		return;
+	}
 
-	int32 Index = 0;
-	do 
+	FGameObjectSlot& Slot = ChildSlots[Index];
+	Slot.Object = nullptr;
+	Slot.Generation++;
+	if ( bIsChildrenLocked )
+	{
+		// No slot may be reused until the children are unlocked.
+		DeferredChildCommands.Add( FGameObjectChildCommand( EGameObjectChildCommand::Remove, nullptr, Index ) );
+	}
+	else
 	{
-		OutID = FString::Printf( TEXT("%s_%d"), *BaseID, Index );
-		Index++;
+		FreeChildSlots.Add( Index );
+	}
+
+	if ( ChildSlotsByID.FindRef( InChild->ID ) == Index )
+	{
+		ChildSlotsByID.Remove( InChild->ID );
+	}
+
+	InChild->SlotIndex = INDEX_NONE;
+	NumChildren--;
+
+	if ( UGameObjectTree* ObjectTree = GetObjectTree() )
+	{
+		ObjectTree->NoteSaveChildrenChanged( this );
 	}
-	while( Children.Contains(OutID) );
 }
 
 bool UGameObjectContainer::LockChildren()
@@ -668,30 +913,156 @@ void UGameObjectContainer::UnlockChildren()
 
 	bIsChildrenLocked = false;
 
-	if ( bIsChildrenDirty )
+	// Apply in order, so a slot freed by a remove is reused by the adds that come after it.
+	for ( const FGameObjectChildCommand& Command : DeferredChildCommands )
 	{
-		FGameObjectMap CleanedMap;
+		if ( Command.Type == EGameObjectChildCommand::Remove )
+		{
+			FreeChildSlots.Add( Command.SlotIndex );
+		}
+		else if ( UGameObject* Child = GetDeferredChild( Command ) )
+		{
+			if ( Child->IsPendingKill() == false )
+			{
+				AllocateChildSlot( Child );
+			}
+		}
+	}
+	DeferredChildCommands.Reset();
+}
 
-		for ( const FGameObjectPair& Pair : Children )
+int32 UGameObjectContainer::SetObjectTreeAndDepth( UGameObject* Root, UGameObjectTree* InObjectTree, int32 InDepth )
+{
+	if ( Root->OwningTree != InObjectTree )
+	{
+		if ( Root->OwningTree )
 		{
-			UGameObject* Object = Pair.Value;
-			if ( Object && Object->GetParent() == this && Object->IsPendingKill() == false )
+			Root->OwningTree->RemoveFromClassIndex( Root );
+			Root->OwningTree->NoteSaveRemoved( Root );
+			if ( Root->PoolCountingTree.Get() == Root->OwningTree )
 			{
-				CleanedMap.Add( Object->ID, Object );
+				UGameObjectTree::UncountActivePooledObject( Root );
 			}
 		}
+		if ( InObjectTree )
+		{
+			InObjectTree->AddToClassIndex( Root );
+			InObjectTree->NoteSaveDirty( Root );
+			InObjectTree->CountActivePooledObject( Root );
+		}
+	}
+	Root->OwningTree = InObjectTree;
+	Root->Depth = InDepth;
 
-		for ( UGameObject* Object : PendingAddedChildren )
+	UGameObjectContainer* Container = Cast<UGameObjectContainer>( Root );
+	if ( !Container )
+	{
+		return GetTreeEventListenerWeight( Root );
+	}
+
+	// Recount the listeners while walking the subtree anyway, so the counts are right even after loading.
+	int32 NumListeners = 0;
+	for ( const FGameObjectSlot& Slot : Container->ChildSlots )
+	{
+		if ( Slot.Object && Slot.Object->Parent.Get() == Container )
+		{
+			NumListeners += SetObjectTreeAndDepth( Slot.Object, InObjectTree, InDepth + 1 );
+		}
+	}
+	for ( const FGameObjectChildCommand& Command : Container->DeferredChildCommands )
+	{
+		if ( UGameObject* Child = Container->GetDeferredChild( Command ) )
 		{
-			if ( Object && Object->GetParent() == this && Object->IsPendingKill() == false )
+			NumListeners += SetObjectTreeAndDepth( Child, InObjectTree, InDepth + 1 );
+		}
+	}
+	Container->NumTreeEventListeners = NumListeners;
+
+	return GetTreeEventListenerWeight( Root );
+}
+
+int32 UGameObjectContainer::GetTreeEventListenerWeight( const UGameObject* Object )
+{
+	const UGameObjectContainer* Container = Cast<UGameObjectContainer>( Object );
+	return ( Object->bWantsObjectTreeEvents ? 1 : 0 ) + ( Container ? Container->NumTreeEventListeners : 0 );
+}
+
+void UGameObjectContainer::AdjustTreeEventListeners( int32 Delta )
+{
+	if ( Delta != 0 )
+	{
+		for ( UGameObjectContainer* Container = this; Container; Container = Container->Parent.Get() )
+		{
+			Container->NumTreeEventListeners += Delta;
+		}
+	}
+}
+
+void UGameObjectContainer::NotifyTreeEventListeners( UGameObjectTree* InObjectTree, bool bAdded )
+{
+	// Only descend into the children that are listeners themselves or have listeners below them.
+	auto NotifyOne = [InObjectTree, bAdded]( UGameObject* Child )
+	{
+		if ( Child->bWantsObjectTreeEvents )
+		{
+			if ( bAdded )
+			{
+				Child->OnAddedToObjectTree( InObjectTree );
+			}
+			else
 			{
-				CleanedMap.Add( Object->ID, Object );
+				Child->OnRemovedFromObjectTree( InObjectTree );
 			}
 		}
-		PendingAddedChildren.Empty();
+		UGameObjectContainer* Container = Cast<UGameObjectContainer>( Child );
+		if ( Container && Container->NumTreeEventListeners > 0 )
+		{
+			Container->NotifyTreeEventListeners( InObjectTree, bAdded );
+		}
+	};
 
-		Children = CleanedMap;
+	bool bLockingChildren = LockChildren();
 
-		bIsChildrenDirty = false;
+	for ( int32 Index = 0; Index < ChildSlots.Num(); Index++ )
+	{
+		UGameObject* Child = ChildSlots[Index].Object;
+		if ( Child && Child->GetParent() == this && Child->IsPendingKill() == false )
+		{
+			NotifyOne( Child );
+		}
+	}
+	for ( int32 Index = 0; Index < DeferredChildCommands.Num(); Index++ )
+	{
+		UGameObject* Child = GetDeferredChild( DeferredChildCommands[Index] );
+		if ( Child && Child->IsPendingKill() == false )
+		{
+			NotifyOne( Child );
+		}
+	}
+
+	if ( bLockingChildren )
+	{
+		UnlockChildren();
+	}
+}
+
+UGameObject* UGameObjectContainer::GetDeferredChild( const FGameObjectChildCommand& Command ) const
+{
+	UGameObject* Child = Command.Object;
+	if ( Command.Type != EGameObjectChildCommand::Add || !Child || Child->Parent.Get() != this || Child->SlotIndex != INDEX_NONE )
+	{
+		return nullptr;
+	}
+	return Child;
+}
+
+void UGameObjectContainer::CancelDeferredAdd( UGameObject* InChild )
+{
+	for ( FGameObjectChildCommand& Command : DeferredChildCommands )
+	{
+		if ( Command.Type == EGameObjectChildCommand::Add && Command.Object == InChild )
+		{
+			Command.Object = nullptr;
+		}
 	}
 }
\ No newline at end of file
@@ -0,0 +1,240 @@
+// @Author Fathurahman <ipat.bogor@gmail.com> @ipatizer
+#include "GamePrivatePCH.h"
+#include "Util/GameObjectMemoryReport.h"
+#include "Object/GameObjectTree.h"
+#include "Framework/GameManager.h"
+#include "GameStats.h"
+
+DEFINE_STAT( STAT_GameObjectMemory_Objects );
+DEFINE_STAT( STAT_GameObjectMemory_Shallow );
+DEFINE_STAT( STAT_GameObjectMemory_Deep );
+DEFINE_STAT( STAT_GameObjectMemory_Tags );
+DEFINE_STAT( STAT_GameObjectMemory_IDs );
+
+static float GMemStatInterval = 0.0f;
+static FAutoConsoleVariableRef CVarMemStatInterval(
+	TEXT("GameObjects.MemStatInterval"),
+	GMemStatInterval,
+	TEXT("Seconds between the memory reports that update the GameObjectMemory stats, 0 to only update them with GameObjects.MemReport."),
+	ECVF_Default );
+
+//////////////////////////////////////////////////////////////////////////
+// FGameObjectClassMemory
+//////////////////////////////////////////////////////////////////////////
+
+void FGameObjectClassMemory::Accumulate( const FGameObjectClassMemory& Other, int32 Sign )
+{
+	NumObjects += Sign * Other.NumObjects;
+	ShallowBytes += Sign * Other.ShallowBytes;
+	DeepBytes += Sign * Other.DeepBytes;
+	TagBytes += Sign * Other.TagBytes;
+	IDBytes += Sign * Other.IDBytes;
+}
+
+//////////////////////////////////////////////////////////////////////////
+// FGameObjectMemoryReport
+//////////////////////////////////////////////////////////////////////////
+
+/** Memory allocated by an object for its properties and native members, not including the object itself. */
+static int64 GetOwnedBytes( const UObject* Object )
+{
+	UObject* MutableObject = const_cast<UObject*>( Object );
+	FArchiveCountMem CountMem( MutableObject );
+	return (int64) CountMem.GetMax() + (int64) MutableObject->GetResourceSize( EResourceSizeMode::Exclusive );
+}
+
+FGameObjectMemoryReport FGameObjectMemoryReport::Capture( const UGameObjectTree* Tree )
+{
+	FGameObjectMemoryReport Report;
+	Report.Time = FDateTime::Now();
+	if ( !Tree )
+	{
+		return Report;
+	}
+
+	TMap<UClass*, FGameObjectClassMemory> MemoryByClass;
+	TMap<UClass*, TSet<FName>> IDsByClass;
+	TArray<UObject*> Subobjects;
+
+	auto AddObject = [&]( const UGameObject* Object )
+	{
+		UClass* Class = Object->GetClass();
+		FGameObjectClassMemory& Memory = MemoryByClass.FindOrAdd( Class );
+		const int64 ShallowBytes = Class->GetPropertiesSize();
+		Memory.NumObjects++;
+		Memory.ShallowBytes += ShallowBytes;
+		Memory.DeepBytes += ShallowBytes + GetOwnedBytes( Object );
+		Memory.TagBytes += Object->GetTagsAllocatedSize();
+
+		Subobjects.Reset();
+		GetObjectsWithOuter( Object, Subobjects, true );
+		for ( const UObject* Subobject : Subobjects )
+		{
+			Memory.DeepBytes += Subobject->GetClass()->GetPropertiesSize() + GetOwnedBytes( Subobject );
+		}
+
+		if ( !Object->GetIDName().IsNone() )
+		{
+			IDsByClass.FindOrAdd( Class ).Add( Object->GetIDName() );
+		}
+	};
+
+	AddObject( Tree );
+	Tree->ForEachDescendant( []( UGameObject* ) { return true; }, [&]( UGameObject* Object ) { AddObject( Object ); return true; } );
+
+	TArray<UGameObject*> PooledObjects;
+	Tree->GetPooledObjects( PooledObjects );
+	for ( const UGameObject* Object : PooledObjects )
+	{
+		AddObject( Object );
+	}
+
+	for ( TPair<UClass*, FGameObjectClassMemory>& Pair : MemoryByClass )
+	{
+		FGameObjectClassMemory& Memory = Pair.Value;
+		Memory.ClassName = Pair.Key->GetName();
+		if ( const TSet<FName>* IDs = IDsByClass.Find( Pair.Key ) )
+		{
+			for ( const FName& ID : *IDs )
+			{
+				Memory.IDBytes += ID.GetPlainNameString().Len() + 1;
+			}
+		}
+		Report.Total.Accumulate( Memory );
+		Report.Classes.Add( Memory );
+	}
+	Report.Total.ClassName = TEXT("Total");
+
+	Report.Classes.Sort( []( const FGameObjectClassMemory& A, const FGameObjectClassMemory& B ) { return A.DeepBytes > B.DeepBytes; } );
+	return Report;
+}
+
+FGameObjectMemoryReport FGameObjectMemoryReport::DiffFrom( const FGameObjectMemoryReport& Earlier ) const
+{
+	TMap<FString, FGameObjectClassMemory> DiffByClass;
+	for ( const FGameObjectClassMemory& Memory : Classes )
+	{
+		DiffByClass.FindOrAdd( Memory.ClassName ).Accumulate( Memory, 1 );
+	}
+	for ( const FGameObjectClassMemory& Memory : Earlier.Classes )
+	{
+		DiffByClass.FindOrAdd( Memory.ClassName ).Accumulate( Memory, -1 );
+	}
+
+	FGameObjectMemoryReport Diff;
+	Diff.Time = Time;
+	for ( TPair<FString, FGameObjectClassMemory>& Pair : DiffByClass )
+	{
+		FGameObjectClassMemory& Memory = Pair.Value;
+		if ( Memory.NumObjects != 0 || Memory.DeepBytes != 0 || Memory.IDBytes != 0 )
+		{
+			Memory.ClassName = Pair.Key;
+			Diff.Classes.Add( Memory );
+		}
+	}
+	Diff.Total = Total;
+	Diff.Total.Accumulate( Earlier.Total, -1 );
+	Diff.Total.ClassName = TEXT("Total");
+
+	// Biggest growth first.
+	Diff.Classes.Sort( []( const FGameObjectClassMemory& A, const FGameObjectClassMemory& B ) { return A.DeepBytes > B.DeepBytes; } );
+	return Diff;
+}
+
+void FGameObjectMemoryReport::Print( FOutputDevice& Ar ) const
+{
+	auto PrintRow = [&Ar]( const FGameObjectClassMemory& Memory )
+	{
+		Ar.Logf( TEXT("%-48s %10d %12.1f %12.1f %12.1f %12.1f"), *Memory.ClassName, Memory.NumObjects, 
+			Memory.ShallowBytes / 1024.0, Memory.DeepBytes / 1024.0, Memory.TagBytes / 1024.0, Memory.IDBytes / 1024.0 );
+	};
+
+	Ar.Logf( TEXT("Game object memory at %s"), *Time.ToString() );
+	Ar.Logf( TEXT("%-48s %10s %12s %12s %12s %12s"), TEXT("Class"), TEXT("Count"), TEXT("Shallow KB"), TEXT("Deep KB"), TEXT("Tags KB"), TEXT("IDs KB") );
+	for ( const FGameObjectClassMemory& Memory : Classes )
+	{
+		PrintRow( Memory );
+	}
+	PrintRow( Total );
+}
+
+void FGameObjectMemoryReport::UpdateStats() const
+{
+	SET_DWORD_STAT( STAT_GameObjectMemory_Objects, Total.NumObjects );
+	SET_MEMORY_STAT( STAT_GameObjectMemory_Shallow, Total.ShallowBytes );
+	SET_MEMORY_STAT( STAT_GameObjectMemory_Deep, Total.DeepBytes );
+	SET_MEMORY_STAT( STAT_GameObjectMemory_Tags, Total.TagBytes );
+	SET_MEMORY_STAT( STAT_GameObjectMemory_IDs, Total.IDBytes );
+}
+
+void FGameObjectMemoryReport::TickStats( const UGameObjectTree* Tree )
+{
+#if STATS
+	static double LastCaptureTime = 0.0;
+	const double CurrentTime = FPlatformTime::Seconds();
+	if ( GMemStatInterval > 0.0f && Tree && CurrentTime - LastCaptureTime >= GMemStatInterval )
+	{
+		LastCaptureTime = CurrentTime;
+		Capture( Tree ).UpdateStats();
+	}
+#endif
+}
+
+//////////////////////////////////////////////////////////////////////////
+// Console commands
+//////////////////////////////////////////////////////////////////////////
+
+static const UGameObjectTree* GetCurrentObjectTree()
+{
+	UGameManager* GameManager = UGameManager::Get();
+	UGame* Game = GameManager ? GameManager->GetCurrentGame() : nullptr;
+	return Game ? Game->GetObjectTree() : nullptr;
+}
+
+/** The report kept by GameObjects.MemSnapshot. */
+static FGameObjectMemoryReport GMemSnapshot;
+static bool GHasMemSnapshot = false;
+
+static void MemReportCommand( const TArray<FString>& Args )
+{
+	FGameObjectMemoryReport Report = FGameObjectMemoryReport::Capture( GetCurrentObjectTree() );
+	Report.UpdateStats();
+	Report.Print( *GLog );
+}
+
+static void MemSnapshotCommand( const TArray<FString>& Args )
+{
+	GMemSnapshot = FGameObjectMemoryReport::Capture( GetCurrentObjectTree() );
+	GHasMemSnapshot = true;
+	GMemSnapshot.UpdateStats();
+	GLog->Logf( TEXT("Game object memory snapshot taken, %d objects."), GMemSnapshot.Total.NumObjects );
+}
+
+static void MemDiffCommand( const TArray<FString>& Args )
+{
+	if ( !GHasMemSnapshot )
+	{
+		GLog->Logf( TEXT("No game object memory snapshot, use GameObjects.MemSnapshot first.") );
+		return;
+	}
+
+	FGameObjectMemoryReport Report = FGameObjectMemoryReport::Capture( GetCurrentObjectTree() );
+	Report.UpdateStats();
+	GLog->Logf( TEXT("Changes since the snapshot at %s:"), *GMemSnapshot.Time.ToString() );
+	Report.DiffFrom( GMemSnapshot ).Print( *GLog );
+}
+
+static FAutoConsoleCommand MemReportCmd(
+	TEXT("GameObjects.MemReport"),
+	TEXT("Print the memory used by the objects of the current game's object tree per class."),
+	FConsoleCommandWithArgsDelegate::CreateStatic( &MemReportCommand ) );
+
+static FAutoConsoleCommand MemSnapshotCmd(
+	TEXT("GameObjects.MemSnapshot"),
+	TEXT("Keep a memory report of the current game's object tree for GameObjects.MemDiff."),
+	FConsoleCommandWithArgsDelegate::CreateStatic( &MemSnapshotCommand ) );
+
+static FAutoConsoleCommand MemDiffCmd(
+	TEXT("GameObjects.MemDiff"),
+	TEXT("Print how the memory used by the current game's object tree has changed per class since GameObjects.MemSnapshot."),
+	FConsoleCommandWithArgsDelegate::CreateStatic( &MemDiffCommand ) );
@@ -2,12 +2,116 @@
 #include "GamePrivatePCH.h"
 #include "Object/GameObjectTree.h"
 #include "Framework/Game.h"
+#include "Util/GameUtil.h"
+#include "Util/BlueprintEventCache.h"
+#include "Util/PackedTreeRecord.h"
+#include "Async/ParallelFor.h"
+#include "GameStats.h"
+
+#if !UE_BUILD_SHIPPING
+static int32 GVerifyIncrementalSave = 0;
+static FAutoConsoleVariableRef CVarVerifyIncrementalSave(
+	TEXT("GameObjects.VerifyIncrementalSave"),
+	GVerifyIncrementalSave,
+	TEXT("1 to serialize every object when an incremental save begins, and report the objects that have been changed without CaptureForSave when they are captured."),
+	ECVF_Default );
+#endif
+
+/** A packed record an object tree reads its deferred children from, the reader points into the data. */
+struct FGameObjectDeferredRecord
+{
+	TArray<uint8> Data;
+	FPackedTreeRecordReader Reader;
+};
+
+//////////////////////////////////////////////////////////////////////////
+// FGameObjectTickList
+//////////////////////////////////////////////////////////////////////////
+
+void FGameObjectTickList::Add( UGameObject* Object, int32 UGameObject::* IndexMember )
+{
+	Object->*IndexMember = Objects.Add( Object );
+}
+
+void FGameObjectTickList::Remove( UGameObject* Object, int32 UGameObject::* IndexMember )
+{
+	int32& Index = Object->*IndexMember;
+	if ( Objects.IsValidIndex( Index ) && Objects[Index] == Object )
+	{
+		Objects[Index] = nullptr;
+		NumRemoved++;
+	}
+	Index = INDEX_NONE;
+}
+
+void FGameObjectTickList::Compact( int32 UGameObject::* IndexMember )
+{
+	if ( NumRemoved == 0 )
+	{
+		return;
+	}
+
+	int32 NumObjects = 0;
+	for ( UGameObject* Object : Objects )
+	{
+		if ( Object )
+		{
+			Object->*IndexMember = NumObjects;
+			Objects[NumObjects++] = Object;
+		}
+	}
+	Objects.SetNum( NumObjects, false );
+	NumRemoved = 0;
+}
+
+void FGameObjectTickList::Reset( int32 UGameObject::* IndexMember )
+{
+	for ( UGameObject* Object : Objects )
+	{
+		if ( Object )
+		{
+			Object->*IndexMember = INDEX_NONE;
+		}
+	}
+	Objects.Reset();
+	NumRemoved = 0;
+}
+
+//////////////////////////////////////////////////////////////////////////
+// FGameObjectTickBucket
+//////////////////////////////////////////////////////////////////////////
+
+void FGameObjectTickBucket::Compact()
+{
+	if ( List.NumRemoved == 0 )
+	{
+		return;
+	}
+
+	// Keep the cursor on the same object.
+	int32 NumRemovedBeforeCursor = 0;
+	for ( int32 Index = 0; Index < Cursor; Index++ )
+	{
+		if ( !List.Objects[Index] )
+		{
+			NumRemovedBeforeCursor++;
+		}
+	}
+
+	List.Compact( &UGameObject::SimulationTickIndex );
+	Cursor = List.Objects.Num() > 0 ? ( Cursor - NumRemovedBeforeCursor ) % List.Objects.Num() : 0;
+}
+
+//////////////////////////////////////////////////////////////////////////
+// UGameObjectTree
+//////////////////////////////////////////////////////////////////////////
 
 UGameObjectTree::UGameObjectTree(const FObjectInitializer& ObjectInitializer)
 	: Super( ObjectInitializer )
 {
 	bAllowChildrenToTick = true;
 	bCanTick = bCanSimulationTick = true;
+	TickListIterationDepth = 0;
 }
 
 
@@ -18,7 +122,7 @@ UGameObjectContainer* UGameObjectTree::GetOrCreateContainerForObject( TSubclassO
 		return nullptr;
 	}
 
-	FString ContainerID = FString::Printf( TEXT("GenericContainer_%s"), *InClass->GetName() );
+	FName ContainerID = *FString::Printf( TEXT("GenericContainer_%s"), *InClass->GetName() );
 	
 	UGameObjectContainer* Container = FindChild<UGameObjectContainer>( ContainerID );
 	if ( !Container )
@@ -28,210 +132,2025 @@ UGameObjectContainer* UGameObjectTree::GetOrCreateContainerForObject( TSubclassO
 		UGameObject* CDO = InClass->GetDefaultObject<UGameObject>();
 		if ( !CDO->bCanTick && !CDO->bCanSimulationTick )
 		{
-			Container->bAllowChildrenToTick = false;
+			Container->SetAllowChildrenToTick( false );
 		}
 		else
 		{
-			Container->bCanTick = CDO->bCanTick;
-			Container->bCanSimulationTick = CDO->bCanSimulationTick;
+			Container->SetCanTick( CDO->bCanTick );
+			Container->SetCanSimulationTick( CDO->bCanSimulationTick );
 		}
 	}
 
 	return Container;
 }
 
-bool UGameObjectTree::SaveToRecord( FGameObjectTreeRecord& OutTreeRecord ) const
+void UGameObjectTree::Tick( float DeltaTime )
 {
-	Trace( "Begin Saving ..." );
+	Super::Tick( DeltaTime );
 
-	OutTreeRecord.ObjectRecords.Empty();
-	OutTreeRecord.LinkRecords.Empty();
-	OutTreeRecord.ByteData.Empty();
+	SCOPE_CYCLE_COUNTER( STAT_GameModules_TreeTick );
 
-	TArray<UGameObject*> Objects;
-	GetDescendants( Objects );
+	if ( SaveCapture.IsActive() )
+	{
+		ContinueIncrementalSave();
+	}
 
-	FGameObjectLinkRecord MyLinkRecord;
-	MyLinkRecord.ParentName = NAME_None;
+	TickListIterationDepth++;
 
-	for (UGameObject* Object : Objects)
+	// Objects registered while ticking are appended to the list, they will be ticked starting from the next tick.
+	const int32 NumObjects = WorldTickList.Objects.Num();
+	INC_DWORD_STAT_BY( STAT_GameModules_ObjectsTicked, NumObjects );
+	for ( int32 Index = 0; Index < NumObjects; Index++ )
 	{
-		if (!Object)
+		UGameObject* Object = WorldTickList.Objects[Index];
+		if ( Object && Object->IsPendingKill() == false )
 		{
-			continue;
+			CaptureForSave( Object );
+			Object->Tick( DeltaTime );
 		}
+	}
 
-		FStringAssetReference ObjectRef = Object;
+	TickListIterationDepth--;
 
-		// Create Object record
-		FGameObjectRecord ObjectRecord;
-		ObjectRecord.Class = Object->GetClass();
-		FName ObjectName = ObjectRecord.Name = Object->GetFName();
-		ObjectRecord.ID = Object->ID;
+	if ( TickListIterationDepth == 0 )
+	{
+		WorldTickList.Compact( &UGameObject::WorldTickIndex );
+		CompactSimulationTickLists();
+	}
+}
 
-		// Serialize Object data
-		ObjectRecord.ByteData.Empty();
-		FMemoryWriter Writer(ObjectRecord.ByteData);
-		FSaveGameArchive Ar(Writer);
-		Object->Serialize(Ar);
-		Trace("    Save Object: %s", *GetFullNameSafe(Object));
+void UGameObjectTree::SimulationTick( const FTimespan& Timespan )
+{
+	Super::SimulationTick( Timespan );
 
-		// Add it to tree record.
-		OutTreeRecord.ObjectRecords.Add(ObjectRecord);
+	SCOPE_CYCLE_COUNTER( STAT_GameModules_TreeSimulationTick );
 
-		// If this object is a tree object direct children, record it.
-		if (Object->GetParent() == this)
+	SimulationTime += Timespan;
+
+	TickListIterationDepth++;
+
+	// Take a copy of the roots, the game thread may unregister them while the workers are still picking them up.
+	TArray<FGameObjectSimulationTick> SerialTicks;
+	TArray<FGameObjectSimulationTick> ParallelTicks;
+	ParallelTicks.Reserve( ParallelSimulationRootList.Objects.Num() );
+	for ( UGameObject* Root : ParallelSimulationRootList.Objects )
+	{
+		if ( Root && Root->IsPendingKill() == false )
 		{
-			MyLinkRecord.ChildNames.Add( ObjectName );
-			Trace("   Link Parent( %s ) -> Child( %s )", *GetFullName(), *Object->GetFullName() );
+			ParallelTicks.Add( FGameObjectSimulationTick( Root, Timespan ) );
 		}
+	}
+	CollectDueSimulationTicks( Timespan, SerialTicks, ParallelTicks );
 
-		// If this object is a container, then record its children references.
-		UGameObjectContainer* Container = Cast<UGameObjectContainer>(Object);
-		if (Container)
+	// The thread safe subtrees can not be captured from the workers, capture what is left of them before they are simulated.
+	if ( SaveCapture.IsActive() )
+	{
+		for ( const FGameObjectSimulationTick& ParallelTick : ParallelTicks )
 		{
-			FGameObjectLinkRecord LinkRecord;
-			LinkRecord.ParentName = ObjectName;
-			for (const FGameObjectPair& Pair : Container->Children)
-			{
-				UGameObject* Child = Pair.Value;
-				if (Child)
-				{
-					LinkRecord.ChildNames.Add( Child->GetFName() );
-					Trace("   Link Parent( %s ) -> Child( %s )", *Container->GetFullName(), *Child->GetFullName() );
-				}
-			}
-			OutTreeRecord.LinkRecords.Add(LinkRecord);
+			CaptureSubtreeForSave( ParallelTick.Object );
 		}
 	}
 
-	// Record my Links
-	OutTreeRecord.LinkRecords.Add(MyLinkRecord);
+	// The serial ticks can change the tree, so they never run while the thread safe subtrees are simulated.
+	if ( bSimulateThreadSafeSubtreesLast )
+	{
+		SimulationTickSerial( Timespan, SerialTicks );
+		ParallelFor( ParallelTicks.Num(), [&ParallelTicks]( int32 Index )
+		{
+			SimulationTickThreadSafeSubtree( ParallelTicks[Index] );
+		}, ParallelTicks.Num() < 2 );
+	}
+	else
+	{
+		// Every task keeps picking the next root that nobody has picked yet, so the busy workers do not hold the others back.
+		FThreadSafeCounter NextTickIndex;
+		auto SimulateRoots = [&ParallelTicks, &NextTickIndex]()
+		{
+			for ( int32 Index = NextTickIndex.Increment() - 1; Index < ParallelTicks.Num(); Index = NextTickIndex.Increment() - 1 )
+			{
+				SimulationTickThreadSafeSubtree( ParallelTicks[Index] );
+			}
+		};
 
-	// Serialize my data
-	FMemoryWriter Writer(OutTreeRecord.ByteData);
-	FSaveGameArchive Ar(Writer);
-	UObject* Self = (UObject*) this;
-	Self->Serialize(Ar);
+		FGraphEventArray Tasks;
+		if ( ParallelTicks.Num() > 1 && FPlatformProcess::SupportsMultithreading() )
+		{
+			const int32 NumTasks = FMath::Min( FTaskGraphInterface::Get().GetNumWorkerThreads(), ParallelTicks.Num() );
+			for ( int32 Index = 0; Index < NumTasks; Index++ )
+			{
+				Tasks.Add( FFunctionGraphTask::CreateAndDispatchWhenReady( SimulateRoots, GET_STATID( STAT_GameModules_TreeParallelSimulationTick ), nullptr, ENamedThreads::AnyThread ) );
+			}
+		}
 
-	Trace("Saving ended.");
-	return true;
+		// Help the workers with the roots, then simulate the rest once every subtree is done.
+		SimulateRoots();
 
-}
+		if ( Tasks.Num() > 0 )
+		{
+			FTaskGraphInterface::Get().WaitUntilTasksComplete( Tasks, ENamedThreads::GameThread );
+		}
+		SimulationTickSerial( Timespan, SerialTicks );
+	}
 
-static UGameObject* FindGameObjectInMap(const TMap<UGameObject*, const FGameObjectRecord*>& ObjectMap, const FName& Name)
-{
-	if (Name.IsNone())
+	// Sync point, back on the game thread with every subtree done. The changes are merged in the order of the roots, not in the order they were made.
+	for ( const FGameObjectSimulationTick& ParallelTick : ParallelTicks )
 	{
-		return nullptr;
+		SaveDirtyObjects.Append( ParallelTick.SaveDirtyObjects );
+	}
+	for ( const FGameObjectSimulationTick& ParallelTick : ParallelTicks )
+	{
+		if ( ParallelTick.Object->IsPendingKill() == false )
+		{
+			ParallelTick.Object->OnSimulationTickSynced( ParallelTick.Timespan );
+		}
 	}
-	for (const auto& i : ObjectMap)
+
+	TickListIterationDepth--;
+
+	if ( TickListIterationDepth == 0 )
 	{
-		 UGameObject* Object = (UGameObject*) i.Key;
-		if (Object && Object->GetFName() == Name)
-			return Object;
+		CompactSimulationTickLists();
 	}
-	return nullptr;
 }
 
-bool UGameObjectTree::LoadFromRecord(const FGameObjectTreeRecord& InTreeRecord)
+void UGameObjectTree::CollectDueSimulationTicks( const FTimespan& Timespan, TArray<FGameObjectSimulationTick>& OutSerialTicks, TArray<FGameObjectSimulationTick>& OutParallelTicks )
 {
-	UObject* Outer = (UObject*) GetTransientPackage();
+	for ( FGameObjectTickBucket& Bucket : TickBuckets )
+	{
+		TArray<UGameObject*>& Objects = Bucket.List.Objects;
+		if ( Objects.Num() == 0 )
+		{
+			continue;
+		}
 
-	bool bHasError = false;
+		// Visit just enough objects this tick so that every object is visited once per interval.
+		Bucket.Progress += Objects.Num() * ( (double) Timespan.GetTicks() / Bucket.Interval.GetTicks() );
+		const int32 NumDue = FMath::Min( (int32) Bucket.Progress, Objects.Num() );
+		Bucket.Progress = FMath::Min( Bucket.Progress - NumDue, (double) Objects.Num() );
 
-	RemoveChildren( true );
+		for ( int32 Count = 0; Count < NumDue; Count++ )
+		{
+			UGameObject* Object = Objects[Bucket.Cursor];
+			Bucket.Cursor = ( Bucket.Cursor + 1 ) % Objects.Num();
+			if ( !Object || Object->IsPendingKill() )
+			{
+				continue;
+			}
 
-	TMap<UGameObject*, const FGameObjectRecord*> ObjectMap;
+			// Give the object all the time that has passed since it was last ticked.
+			const FGameObjectSimulationTick DueTick( Object, SimulationTime - Object->LastSimulationTickTime );
+			Object->LastSimulationTickTime = SimulationTime;
+			if ( Object->bThreadSafeSimulationTick )
+			{
+				OutParallelTicks.Add( DueTick );
+			}
+			else
+			{
+				OutSerialTicks.Add( DueTick );
+			}
+		}
+	}
+}
 
-	// Recreate game objects
-	for (const FGameObjectRecord& ObjectRecord : InTreeRecord.ObjectRecords)
+void UGameObjectTree::SimulationTickSerial( const FTimespan& Timespan, const TArray<FGameObjectSimulationTick>& DueTicks )
+{
+	const int32 NumObjects = SimulationTickList.Objects.Num();
+	INC_DWORD_STAT_BY( STAT_GameModules_ObjectsSimulationTicked, NumObjects + DueTicks.Num() );
+	for ( int32 Index = 0; Index < NumObjects; Index++ )
 	{
-		// Make sure record is valid
-		if (!ObjectRecord.Class || ObjectRecord.Name.IsNone())
+		UGameObject* Object = SimulationTickList.Objects[Index];
+		if ( Object && Object->IsPendingKill() == false )
 		{
-			PrintLogError( "Corrupt Object's Record: Class='%s', Name='%s'", *GetFullNameSafe(ObjectRecord.Class), *ObjectRecord.Name.ToString() );
-			bHasError = true;
-			continue;
+			CaptureForSave( Object );
+			Object->SimulationTick( Timespan );
 		}
+	}
 
-		// Create object
-		UGameObject* Object = NewObject<UGameObject>( Outer, ObjectRecord.Class, ObjectRecord.Name);
-		if (!Object)
+	// Objects that have been unregistered by the objects ticked before them are skipped.
+	for ( const FGameObjectSimulationTick& DueTick : DueTicks )
+	{
+		if ( DueTick.Object->SimulationTickBucketIndex != INDEX_NONE && DueTick.Object->IsPendingKill() == false )
 		{
-			PrintLogError( "Fail to create Object: Class='%s', Name='%s'" , *GetFullNameSafe(ObjectRecord.Class), *ObjectRecord.Name.ToString() );
-			bHasError = true;
-			continue;
+			CaptureForSave( DueTick.Object );
+			DueTick.Object->SimulationTick( DueTick.Timespan );
 		}
+	}
+}
 
-		// retrieve ID
-		Object->ID = ObjectRecord.ID;
+/** Slot of the dirty objects of the thread safe subtree the thread is simulating, null when it is not simulating one. */
+static const uint32 ThreadSafeSimulationTlsSlot = FPlatformTLS::AllocTlsSlot();
 
-		// Make sure it's not garbage collected
-		Object->AddToRoot();		
+bool UGameObjectTree::IsSimulatingThreadSafeSubtree()
+{
+	return FPlatformTLS::GetTlsValue( ThreadSafeSimulationTlsSlot ) != nullptr;
+}
 
-		// Add it to map for the last loading phase of data serialization.
-		ObjectMap.Add( Object, &ObjectRecord );
-		Trace( "Recreate Object : %s", *Object->GetFullName() );
+void UGameObjectTree::SimulationTickThreadSafeSubtree( FGameObjectSimulationTick& ParallelTick )
+{
+	FPlatformTLS::SetTlsValue( ThreadSafeSimulationTlsSlot, &ParallelTick.SaveDirtyObjects );
+	SimulationTickSubtree( ParallelTick.Object, ParallelTick.Timespan );
+	FPlatformTLS::SetTlsValue( ThreadSafeSimulationTlsSlot, nullptr );
+}
+
+void UGameObjectTree::SimulationTickSubtree( UGameObject* Object, const FTimespan& Timespan )
+{
+	INC_DWORD_STAT( STAT_GameModules_ObjectsSimulationTicked );
+	Object->SimulationTick( Timespan );
+
+	UGameObjectContainer* Container = Cast<UGameObjectContainer>( Object );
+	if ( Container && Container->bAllowChildrenToTick )
+	{
+		for ( const FGameObjectSlot& Slot : Container->ChildSlots )
+		{
+			// Children that an earlier sibling has moved away are simulated with their new parent, if at all.
+			UGameObject* Child = Slot.Object;
+			if ( Child && Child->GetParent() == Container && Child->bCanSimulationTick && Child->IsPendingKill() == false )
+			{
+				SimulationTickSubtree( Child, Timespan );
+			}
+		}
 	}
+}
 
+void UGameObjectTree::AddToClassIndex( UGameObject* Object )
+{
+	TArray<UGameObject*>& Objects = ObjectsByClass.FindOrAdd( Object->GetClass() );
+	Object->ClassIndexSlot = Objects.Add( Object );
+}
 
-	// Rebuild Links
-	for (const FGameObjectLinkRecord& LinkRecord : InTreeRecord.LinkRecords)
+void UGameObjectTree::RemoveFromClassIndex( UGameObject* Object )
+{
+	TArray<UGameObject*>* pObjects = ObjectsByClass.Find( Object->GetClass() );
+	const int32 Index = Object->ClassIndexSlot;
+	if ( !pObjects || !pObjects->IsValidIndex( Index ) || (*pObjects)[Index] != Object )
 	{
-		UGameObjectContainer* Parent;
-		if ( LinkRecord.ParentName.IsNone() )
+		return;
+	}
+
+	// Move the last object into the hole.
+	UGameObject* LastObject = pObjects->Pop( false );
+	if ( LastObject != Object )
+	{
+		(*pObjects)[Index] = LastObject;
+		LastObject->ClassIndexSlot = Index;
+	}
+	Object->ClassIndexSlot = INDEX_NONE;
+}
+
+template<typename FuncType>
+void UGameObjectTree::ForEachObjectOfClass( UClass* InClass, const UGameObjectContainer* InAncestor, const FString& InTag, const FuncType& Func ) const
+{
+	const bool bIsAncestorSpecified = InAncestor && InAncestor != this;
+	const bool bIsTagSpecified = !InTag.IsEmpty();
+	const int32 TagIndex = bIsTagSpecified ? FGameTagTable::Get().Find( InTag ) : INDEX_NONE;
+	if ( bIsTagSpecified && TagIndex == INDEX_NONE )
+	{
+		return;
+	}
+
+	// A subtree that is smaller than the buckets of the class is walked instead, its size is only known from the interval numbering.
+	if ( bIsAncestorSpecified && HasValidIntervalNumbering() )
+	{
+		int32 NumIndexedObjects = 0;
+		for ( const TPair<UClass*, TArray<UGameObject*>>& Pair : ObjectsByClass )
 		{
-			Parent = Cast<UGameObjectContainer>( this );
+			NumIndexedObjects += Pair.Key->IsChildOf( InClass ) ? Pair.Value.Num() : 0;
 		}
-		else
+		if ( InAncestor->IntervalEnd - InAncestor->IntervalBegin < NumIndexedObjects )
 		{
-			Parent = Cast<UGameObjectContainer>( FindGameObjectInMap(ObjectMap, LinkRecord.ParentName) );
+			InAncestor->ForEachDescendant( [=]( UGameObject* Object )
+			{
+				return Object->IsA( InClass ) && Object->IsPendingKill() == false
+					&& ( !bIsTagSpecified || Object->HasTag( TagIndex ) );
+			}, Func );
+			return;
 		}
+	}
 
-		if ( !Parent )
+	for ( const TPair<UClass*, TArray<UGameObject*>>& Pair : ObjectsByClass )
+	{
+		if ( Pair.Key->IsChildOf( InClass ) == false )
 		{
-			PrintLogError( "Parent is not a container" );
-			bHasError = true;
 			continue;
 		}
 
-		for ( const FName& ChildName : LinkRecord.ChildNames )	
+		for ( UGameObject* Object : Pair.Value )
 		{
-			UGameObject* Child = Cast<UGameObject>( FindGameObjectInMap(ObjectMap, ChildName) );
-			if ( !Child )
+			if ( Object->IsPendingKill()
+				|| ( bIsAncestorSpecified && InAncestor->IsAncestorOf( Object ) == false )
+				|| ( bIsTagSpecified && Object->HasTag( TagIndex ) == false ) )
 			{
-				PrintLogError( "Child is not a game object" );
-				bHasError = true;
 				continue;
 			}
-
-			Child->Parent = Parent;
-			Parent->Children.Add( Child->ID, Child );
-			Trace( "[%s] Parent: (%s) -> [%s] Child (%s)", *Parent->ID, *Parent->GetPathName(), *Child->ID, *Child->GetPathName() );
+			if ( !Func( Object ) )
+			{
+				return;
+			}
 		}
 	}
+}
 
-	// Serialize objects
-	for (const TPair<UGameObject*, const FGameObjectRecord*>& Pair : ObjectMap)
+int32 UGameObjectTree::FindObjectsByClass( UClass* InClass, const UGameObjectContainer* InAncestor, const FString& InTag, TArray<UGameObject*>& OutObjects ) const
+{
+	OutObjects.Reset();
+	ForEachObjectOfClass( InClass, InAncestor, InTag, [&OutObjects]( UGameObject* Object )
 	{
-		UGameObject* Object = Pair.Key;
-		const TArray<uint8>& ByteData = Pair.Value->ByteData;
+		OutObjects.Add( Object );
+		return true;
+	});
 
-		FMemoryReader MemoryReader(ByteData);
-		FSaveGameArchive Ar(MemoryReader);
-		Object->Serialize(Ar);
+	// The order of the index depends on the history of the tree, the objects are put back in depth first order.
+	if ( HasValidIntervalNumbering() )
+	{
+		OutObjects.Sort( []( const UGameObject& A, const UGameObject& B )
+		{
+			return A.IntervalBegin < B.IntervalBegin;
+		});
+	}
+	else
+	{
+		OutObjects.Sort( []( const UGameObject& A, const UGameObject& B )
+		{
+			return IsBeforeInPreOrder( &A, &B );
+		});
+	}
+	return OutObjects.Num();
+}
 
-		// It's now okay to remove it from ''root''.
-		Object->RemoveFromRoot();
+UGameObject* UGameObjectTree::FindObjectByClass( UClass* InClass, const UGameObjectContainer* InAncestor, const FString& InTag ) const
+{
+	// The match that a recursive FindChild would find is kept: the children of the ancestor first, then the first descendant in depth first order.
+	const UGameObjectContainer* Ancestor = InAncestor ? InAncestor : this;
+	const bool bUseIntervals = HasValidIntervalNumbering();
+	UGameObject* FoundObject = nullptr;
+	bool bIsFoundChild = false;
+	ForEachObjectOfClass( InClass, InAncestor, InTag, [&]( UGameObject* Object )
+	{
+		const bool bIsChild = ( Object->GetParent() == Ancestor );
+		if ( !FoundObject || ( bIsChild && !bIsFoundChild )
+			|| ( bIsChild == bIsFoundChild && ( bUseIntervals ? Object->IntervalBegin < FoundObject->IntervalBegin : IsBeforeInPreOrder( Object, FoundObject ) ) ) )
+		{
+			FoundObject = Object;
+			bIsFoundChild = bIsChild;
+		}
+		return true;
+	});
+	return FoundObject;
+}
+
+bool UGameObjectTree::IsBeforeInPreOrder( const UGameObject* A, const UGameObject* B )
+{
+	// An ancestor comes before its descendants.
+	const UGameObject* AncestorOfA = A;
+	const UGameObject* AncestorOfB = B;
+	while ( AncestorOfA->Depth > AncestorOfB->Depth )
+	{
+		AncestorOfA = AncestorOfA->GetParent();
+	}
+	while ( AncestorOfB->Depth > AncestorOfA->Depth )
+	{
+		AncestorOfB = AncestorOfB->GetParent();
+	}
+	if ( AncestorOfA == AncestorOfB )
+	{
+		return A->Depth < B->Depth;
 	}
 
-	// Serialize self
-	FMemoryReader MemoryReader(InTreeRecord.ByteData);
-	FSaveGameArchive Ar(MemoryReader);
-	this->Serialize(Ar);
+	while ( AncestorOfA->GetParent() != AncestorOfB->GetParent() )
+	{
+		AncestorOfA = AncestorOfA->GetParent();
+		AncestorOfB = AncestorOfB->GetParent();
+	}
 
+	// Then the subtrees of the children of the common ancestor in the order of their slots.
+	const uint32 SlotOfA = (uint32) AncestorOfA->SlotIndex;
+	const uint32 SlotOfB = (uint32) AncestorOfB->SlotIndex;
+	return SlotOfA < SlotOfB;
+}
 
-	return bHasError == false;
+void UGameObjectTree::RebuildClassIndex()
+{
+	ResetClassIndex();
+	ForEachDescendant( []( UGameObject* Object ) { return true; }, [this]( UGameObject* Object )
+	{
+		AddToClassIndex( Object );
+		return true;
+	});
+}
+
+void UGameObjectTree::RebuildAllClassIndices()
+{
+	for ( TObjectIterator<UGameObjectTree> It; It; ++It )
+	{
+		if ( !It->IsPendingKill() && !It->HasAnyFlags( RF_ClassDefaultObject ) )
+		{
+			It->RebuildClassIndex();
+		}
+	}
+}
+
+void UGameObjectTree::ResetClassIndex()
+{
+	for ( const TPair<UClass*, TArray<UGameObject*>>& Pair : ObjectsByClass )
+	{
+		for ( UGameObject* Object : Pair.Value )
+		{
+			Object->ClassIndexSlot = INDEX_NONE;
+		}
+	}
+	ObjectsByClass.Empty();
 }
 
+bool UGameObjectTree::HasValidIntervalNumbering() const
+{
+	if ( !bUseIntervalNumbering )
+	{
+		return false;
+	}
+
+	// The numbering is only redone on the game thread, the objects are not modified from anywhere else.
+	if ( !bIsIntervalNumberingValid && IsInGameThread() )
+	{
+		const_cast<UGameObjectTree*>( this )->RenumberIntervals();
+	}
+	return bIsIntervalNumberingValid;
+}
+
+void UGameObjectTree::RenumberIntervals()
+{
+	bIsIntervalNumberingValid = true;
+	RenumberIntervals_Recursive( this, 0 );
+}
+
+int32 UGameObjectTree::RenumberIntervals_Recursive( UGameObject* Object, int32 NextNumber )
+{
+	Object->IntervalBegin = NextNumber++;
+
+	if ( UGameObjectContainer* Container = Cast<UGameObjectContainer>( Object ) )
+	{
+		for ( const FGameObjectSlot& Slot : Container->ChildSlots )
+		{
+			if ( Slot.Object && Slot.Object->GetParent() == Container )
+			{
+				NextNumber = RenumberIntervals_Recursive( Slot.Object, NextNumber );
+			}
+		}
+		for ( const FGameObjectChildCommand& Command : Container->DeferredChildCommands )
+		{
+			if ( UGameObject* Child = Container->GetDeferredChild( Command ) )
+			{
+				NextNumber = RenumberIntervals_Recursive( Child, NextNumber );
+			}
+		}
+	}
+
+	Object->IntervalEnd = NextNumber;
+	return NextNumber;
+}
+
+void UGameObjectTree::OnDispose()
+{
+	CancelIncrementalSave();
+	ResetSaveDirtyState( FGuid() );
+	ResetDeferredSubtrees();
+	EmptyPools();
+
+	WorldTickList.Reset( &UGameObject::WorldTickIndex );
+	ResetSimulationTickLists();
+	ResetClassIndex();
+
+	Super::OnDispose();
+}
+
+int32 UGameObjectTree::PrewarmPool( TSubclassOf<UGameObject> InClass, int32 InCount )
+{
+	if ( !*InClass || !InClass->GetDefaultObject<UGameObject>()->bPoolable )
+	{
+		return 0;
+	}
+
+	FGameObjectPool& Pool = FindOrAddPool( InClass );
+	if ( MaxPooledObjectsPerClass > 0 )
+	{
+		InCount = FMath::Min( InCount, MaxPooledObjectsPerClass );
+	}
+
+	Pool.Objects.Reserve( InCount );
+	while ( Pool.Objects.Num() < InCount )
+	{
+		UGameObject* Object = StaticCreateGameObject( InClass );
+		Object->bIsInPool = true;
+		Pool.Objects.Add( Object );
+	}
+	return Pool.Objects.Num();
+}
+
+void UGameObjectTree::EmptyPools()
+{
+	TArray<FGameObjectPool> OldPools = MoveTemp( Pools );
+	PoolIndicesByClass.Empty();
+
+	for ( FGameObjectPool& Pool : OldPools )
+	{
+		for ( UGameObject* Object : Pool.Objects )
+		{
+			Object->bIsInPool = false;
+			Object->Dispose_Internal( nullptr );
+		}
+	}
+}
+
+int32 UGameObjectTree::GetNumPooledObjects( TSubclassOf<UGameObject> InClass ) const
+{
+	const FGameObjectPool* Pool = FindPool( InClass );
+	return Pool ? Pool->Objects.Num() : 0;
+}
+
+int32 UGameObjectTree::GetPoolHighWaterMark( TSubclassOf<UGameObject> InClass ) const
+{
+	const FGameObjectPool* Pool = FindPool( InClass );
+	return Pool ? Pool->HighWaterMark : 0;
+}
+
+UGameObject* UGameObjectTree::CreatePooledObject( UClass* InClass )
+{
+	check( IsInGameThread() );
+
+	FGameObjectPool& Pool = FindOrAddPool( InClass );
+
+	UGameObject* Object = nullptr;
+	while ( !Object && Pool.Objects.Num() > 0 )
+	{
+		// Objects that were marked pending kill by someone else while pooled are dropped.
+		Object = Pool.Objects.Pop( false );
+		Object->bIsInPool = false;
+		if ( Object->IsPendingKill() )
+		{
+			Object = nullptr;
+		}
+	}
+	if ( !Object )
+	{
+		Object = StaticCreateGameObject( InClass );
+	}
+
+	CountActivePooledObject( Object );
+	return Object;
+}
+
+void UGameObjectTree::CountActivePooledObject( UGameObject* Object )
+{
+	if ( !Object->bPoolable || Object->PoolCountingTree.Get() == this )
+	{
+		return;
+	}
+	UncountActivePooledObject( Object );
+
+	FGameObjectPool& Pool = FindOrAddPool( Object->GetClass() );
+	Pool.NumActive++;
+	Pool.HighWaterMark = FMath::Max( Pool.HighWaterMark, Pool.NumActive );
+	Object->PoolCountingTree = this;
+}
+
+void UGameObjectTree::UncountActivePooledObject( UGameObject* Object )
+{
+	if ( UGameObjectTree* ObjectTree = Object->PoolCountingTree.Get() )
+	{
+		FGameObjectPool& Pool = ObjectTree->FindOrAddPool( Object->GetClass() );
+		Pool.NumActive--;
+		check( Pool.NumActive >= 0 );
+	}
+	Object->PoolCountingTree.Reset();
+}
+
+void UGameObjectTree::GetPooledObjects( TArray<UGameObject*>& OutObjects ) const
+{
+	OutObjects.Reset();
+	for ( const FGameObjectPool& Pool : Pools )
+	{
+		OutObjects.Append( Pool.Objects );
+	}
+}
+
+SIZE_T UGameObjectTree::GetResourceSize( EResourceSizeMode::Type Mode )
+{
+	SIZE_T Size = Super::GetResourceSize( Mode ) + ObjectsByClass.GetAllocatedSize() + PoolIndicesByClass.GetAllocatedSize() + DeferredSubtrees.GetAllocatedSize() + DeferredSubtreeIndicesByID.GetAllocatedSize();
+	if ( DeferredRecord.IsValid() )
+	{
+		Size += DeferredRecord->Data.GetAllocatedSize();
+	}
+	for ( const TPair<UClass*, TArray<UGameObject*>>& Pair : ObjectsByClass )
+	{
+		Size += Pair.Value.GetAllocatedSize();
+	}
+	return Size;
+}
+
+FGameObjectPool* UGameObjectTree::FindPool( UClass* InClass )
+{
+	const int32* Index = PoolIndicesByClass.Find( InClass );
+	return Index ? &Pools[*Index] : nullptr;
+}
+
+const FGameObjectPool* UGameObjectTree::FindPool( UClass* InClass ) const
+{
+	const int32* Index = PoolIndicesByClass.Find( InClass );
+	return Index ? &Pools[*Index] : nullptr;
+}
+
+FGameObjectPool& UGameObjectTree::FindOrAddPool( UClass* InClass )
+{
+	if ( FGameObjectPool* Pool = FindPool( InClass ) )
+	{
+		return *Pool;
+	}
+
+	PoolIndicesByClass.Add( InClass, Pools.Num() );
+	FGameObjectPool& Pool = Pools[ Pools.AddDefaulted() ];
+	Pool.Class = InClass;
+	return Pool;
+}
+
+bool UGameObjectTree::ReturnToPool( UGameObject* Object )
+{
+	check( IsInGameThread() );
+
+	// A tree that is being disposed does not take objects anymore.
+	if ( IsPendingKill() )
+	{
+		return false;
+	}
+
+	UncountActivePooledObject( Object );
+
+	FGameObjectPool& Pool = FindOrAddPool( Object->GetClass() );
+	if ( MaxPooledObjectsPerClass > 0 && Pool.Objects.Num() >= MaxPooledObjectsPerClass )
+	{
+		return false;
+	}
+
+	Object->ID = NAME_None;
+	Object->SaveName = NAME_None;
+	Object->bIsInPool = true;
+	Object->OnReturnedToPool( this );
+
+	// The pools may have grown while the object was being reset.
+	FindOrAddPool( Object->GetClass() ).Objects.Add( Object );
+	return true;
+}
+
+/** Blueprint events of UGameObjectTree, in the order of their names in TreeEvents. */
+enum EGameObjectTreeEvent
+{
+	GOTE_SubtreeAdded,
+	GOTE_SubtreeRemoved,
+};
+
+static FBlueprintEventCache TreeEvents( {
+	TEXT("ReceiveSubtreeAdded"),
+	TEXT("ReceiveSubtreeRemoved"),
+} );
+
+void UGameObjectTree::OnSubtreeAdded( UGameObject* Root )
+{
+	if ( TreeEvents.IsImplemented( this, GOTE_SubtreeAdded ) )
+	{
+		ReceiveSubtreeAdded( Root );
+	}
+}
+
+void UGameObjectTree::OnSubtreeRemoved( UGameObject* Root )
+{
+	if ( TreeEvents.IsImplemented( this, GOTE_SubtreeRemoved ) )
+	{
+		ReceiveSubtreeRemoved( Root );
+	}
+}
+
+void UGameObjectTree::NotifySubtreeAdded( UGameObject* Root )
+{
+	Root->OnAddedToObjectTree( this );
+
+	UGameObjectContainer* Container = Cast<UGameObjectContainer>( Root );
+	if ( Container && Container->NumTreeEventListeners > 0 )
+	{
+		Container->NotifyTreeEventListeners( this, true );
+	}
+
+	OnSubtreeAdded( Root );
+}
+
+void UGameObjectTree::NotifySubtreeRemoved( UGameObject* Root )
+{
+	Root->OnRemovedFromObjectTree( this );
+
+	UGameObjectContainer* Container = Cast<UGameObjectContainer>( Root );
+	if ( Container && Container->NumTreeEventListeners > 0 )
+	{
+		Container->NotifyTreeEventListeners( this, false );
+	}
+
+	OnSubtreeRemoved( Root );
+}
+
+void UGameObjectTree::RegisterSubtree( UGameObject* Root )
+{
+	// Ancestors that do not tick or do not allow their children to tick prevent the whole subtree from ticking.
+	bool bAllowsTick = bAllowChildrenToTick;
+	bool bAllowsSimulationTick = bAllowChildrenToTick;
+	bool bInParallelSimulationRoot = false;
+	for ( UGameObjectContainer* Container = Root->GetParent(); Container && Container != this; Container = Container->GetParent() )
+	{
+		bAllowsTick = bAllowsTick && Container->bCanTick && Container->bAllowChildrenToTick;
+		bAllowsSimulationTick = bAllowsSimulationTick && Container->bCanSimulationTick && Container->bAllowChildrenToTick;
+		bInParallelSimulationRoot = bInParallelSimulationRoot || ( Container->bThreadSafeSimulationTick && IsRegisteredForSimulationTick( Container ) );
+	}
+
+	RegisterSubtree_Recursive( Root, bAllowsTick, bAllowsSimulationTick, bInParallelSimulationRoot );
+}
+
+void UGameObjectTree::RegisterSubtree_Recursive( UGameObject* Object, bool bParentAllowsTick, bool bParentAllowsSimulationTick, bool bInParallelSimulationRoot )
+{
+	if ( Object->IsPendingKill() )
+	{
+		return;
+	}
+
+	const bool bTick = bParentAllowsTick && Object->bCanTick;
+	const bool bSimulationTick = bParentAllowsSimulationTick && Object->bCanSimulationTick;
+
+	if ( bTick && Object->WorldTickIndex == INDEX_NONE )
+	{
+		WorldTickList.Add( Object, &UGameObject::WorldTickIndex );
+	}
+	// Descendants of a thread safe object are simulated by the worker that simulates it.
+	if ( bSimulationTick && !bInParallelSimulationRoot )
+	{
+		AddSimulationTicker( Object );
+		bInParallelSimulationRoot = Object->bThreadSafeSimulationTick;
+	}
+
+	UGameObjectContainer* Container = Cast<UGameObjectContainer>( Object );
+	if ( !Container || !Container->bAllowChildrenToTick || ( !bTick && !bSimulationTick ) )
+	{
+		// Nothing below this object can tick.
+		return;
+	}
+
+	for ( const FGameObjectSlot& Slot : Container->ChildSlots )
+	{
+		if ( Slot.Object && Slot.Object->GetParent() == Container )
+		{
+			RegisterSubtree_Recursive( Slot.Object, bTick, bSimulationTick, bInParallelSimulationRoot );
+		}
+	}
+	for ( const FGameObjectChildCommand& Command : Container->DeferredChildCommands )
+	{
+		if ( UGameObject* Child = Container->GetDeferredChild( Command ) )
+		{
+			RegisterSubtree_Recursive( Child, bTick, bSimulationTick, bInParallelSimulationRoot );
+		}
+	}
+}
+
+void UGameObjectTree::UnregisterSubtree( UGameObject* Root )
+{
+	// The subtree is about to leave this tree or to change how it ticks, the save in progress needs all of it as it was,
+	// pooled objects lose their ID and disposed ones are gone before the save would reach them.
+	if ( SaveCapture.IsActive() )
+	{
+		CaptureSubtreeForSave( Root );
+	}
+
+	UnregisterSubtree_Recursive( Root );
+}
+
+void UGameObjectTree::UnregisterSubtree_Recursive( UGameObject* Object )
+{
+	WorldTickList.Remove( Object, &UGameObject::WorldTickIndex );
+	RemoveSimulationTicker( Object );
+
+	UGameObjectContainer* Container = Cast<UGameObjectContainer>( Object );
+	if ( !Container )
+	{
+		return;
+	}
+
+	for ( const FGameObjectSlot& Slot : Container->ChildSlots )
+	{
+		if ( Slot.Object && Slot.Object->GetParent() == Container )
+		{
+			UnregisterSubtree_Recursive( Slot.Object );
+		}
+	}
+	for ( const FGameObjectChildCommand& Command : Container->DeferredChildCommands )
+	{
+		if ( UGameObject* Child = Container->GetDeferredChild( Command ) )
+		{
+			UnregisterSubtree_Recursive( Child );
+		}
+	}
+}
+
+void UGameObjectTree::AddSimulationTicker( UGameObject* Object )
+{
+	if ( IsRegisteredForSimulationTick( Object ) )
+	{
+		return;
+	}
+
+	if ( Object->SimulationTickInterval > FTimespan::Zero() )
+	{
+		int32 BucketIndex = TickBuckets.IndexOfByPredicate( [Object]( const FGameObjectTickBucket& Bucket )
+		{
+			return Bucket.Interval == Object->SimulationTickInterval;
+		});
+		if ( BucketIndex == INDEX_NONE )
+		{
+			BucketIndex = TickBuckets.AddDefaulted();
+			TickBuckets[BucketIndex].Interval = Object->SimulationTickInterval;
+		}
+
+		TickBuckets[BucketIndex].List.Add( Object, &UGameObject::SimulationTickIndex );
+		Object->SimulationTickBucketIndex = BucketIndex;
+		Object->LastSimulationTickTime = SimulationTime;
+	}
+	else if ( Object->bThreadSafeSimulationTick )
+	{
+		ParallelSimulationRootList.Add( Object, &UGameObject::ParallelSimulationRootIndex );
+	}
+	else
+	{
+		SimulationTickList.Add( Object, &UGameObject::SimulationTickIndex );
+	}
+}
+
+void UGameObjectTree::RemoveSimulationTicker( UGameObject* Object )
+{
+	if ( Object->SimulationTickBucketIndex != INDEX_NONE )
+	{
+		TickBuckets[Object->SimulationTickBucketIndex].List.Remove( Object, &UGameObject::SimulationTickIndex );
+		Object->SimulationTickBucketIndex = INDEX_NONE;
+	}
+	else
+	{
+		SimulationTickList.Remove( Object, &UGameObject::SimulationTickIndex );
+	}
+	ParallelSimulationRootList.Remove( Object, &UGameObject::ParallelSimulationRootIndex );
+}
+
+bool UGameObjectTree::IsRegisteredForSimulationTick( const UGameObject* Object )
+{
+	return Object->SimulationTickIndex != INDEX_NONE || Object->ParallelSimulationRootIndex != INDEX_NONE;
+}
+
+void UGameObjectTree::CompactSimulationTickLists()
+{
+	SimulationTickList.Compact( &UGameObject::SimulationTickIndex );
+	ParallelSimulationRootList.Compact( &UGameObject::ParallelSimulationRootIndex );
+	for ( FGameObjectTickBucket& Bucket : TickBuckets )
+	{
+		Bucket.Compact();
+	}
+}
+
+void UGameObjectTree::ResetSimulationTickLists()
+{
+	SimulationTickList.Reset( &UGameObject::SimulationTickIndex );
+	ParallelSimulationRootList.Reset( &UGameObject::ParallelSimulationRootIndex );
+	for ( FGameObjectTickBucket& Bucket : TickBuckets )
+	{
+		for ( UGameObject* Object : Bucket.List.Objects )
+		{
+			if ( Object )
+			{
+				Object->SimulationTickBucketIndex = INDEX_NONE;
+			}
+		}
+		Bucket.List.Reset( &UGameObject::SimulationTickIndex );
+	}
+	TickBuckets.Reset();
+}
+
+void UGameObjectTree::RefreshTickRegistration( UGameObject* Object )
+{
+	if ( Object == this )
+	{
+		RebuildTickLists();
+	}
+	else
+	{
+		UnregisterSubtree( Object );
+		RegisterSubtree( Object );
+	}
+}
+
+void UGameObjectTree::RebuildTickLists()
+{
+	WorldTickList.Reset( &UGameObject::WorldTickIndex );
+	ResetSimulationTickLists();
+
+	for ( const FGameObjectSlot& Slot : ChildSlots )
+	{
+		if ( Slot.Object && Slot.Object->GetParent() == this )
+		{
+			RegisterSubtree_Recursive( Slot.Object, bAllowChildrenToTick, bAllowChildrenToTick, false );
+		}
+	}
+}
+
+bool UGameObjectTree::SaveToRecord( FGameObjectTreeRecord& OutTreeRecord ) const
+{
+	SCOPE_CYCLE_COUNTER( STAT_GameModules_SaveToRecord );
+
+	Trace( "Begin Saving ..." );
+
+	OutTreeRecord.Version = EGameObjectRecordVersion::Latest;
+	OutTreeRecord.ObjectRecords.Empty();
+	OutTreeRecord.LinkRecords.Empty();
+	OutTreeRecord.ByteData.Empty();
+	OutTreeRecord.PackedData.Empty();
+	OutTreeRecord.BaseID.Invalidate();
+	OutTreeRecord.Deltas.Empty();
+
+	// The deferred children can only be saved as they have been loaded, in the packed format.
+	if ( bPackRecords || DeferredSubtrees.Num() > 0 )
+	{
+		SaveToPackedRecord( OutTreeRecord.PackedData );
+		Trace( "Saving ended, packed %d bytes.", OutTreeRecord.PackedData.Num() );
+		return true;
+	}
+
+	TArray<UGameObject*> Objects;
+	GetDescendants( Objects );
+
+	// Every object gets its record index up front, so the links can refer to objects that are recorded after them.
+	TMap<const UGameObject*, int32> RecordIndices;
+	RecordIndices.Reserve( Objects.Num() );
+	OutTreeRecord.ObjectRecords.Reserve( Objects.Num() );
+
+	for (UGameObject* Object : Objects)
+	{
+		if (!Object)
+		{
+			continue;
+		}
+
+		// Create Object record
+		const int32 RecordIndex = OutTreeRecord.ObjectRecords.AddDefaulted();
+		FGameObjectRecord& ObjectRecord = OutTreeRecord.ObjectRecords[RecordIndex];
+		ObjectRecord.Class = Object->GetClass();
+		ObjectRecord.Name = Object->GetSaveName();
+		ObjectRecord.ID = Object->GetID();
+		RecordIndices.Add( Object, RecordIndex );
+
+		// Serialize Object data
+		FMemoryWriter Writer(ObjectRecord.ByteData);
+		FSaveGameArchive Ar(Writer);
+		Object->Serialize(Ar);
+		Trace("    Save Object: %s", *GetFullNameSafe(Object));
+	}
+
+	FGameObjectLinkRecord MyLinkRecord;
+	MyLinkRecord.ParentIndex = INDEX_NONE;
+
+	for (UGameObject* Object : Objects)
+	{
+		if (!Object)
+		{
+			continue;
+		}
+
+		const int32 RecordIndex = RecordIndices.FindChecked( Object );
+
+		// If this object is a tree object direct children, record it.
+		if (Object->GetParent() == this)
+		{
+			MyLinkRecord.ChildIndices.Add( RecordIndex );
+			Trace("   Link Parent( %s ) -> Child( %s )", *GetFullName(), *Object->GetFullName() );
+		}
+
+		// If this object is a container, then record its children references.
+		UGameObjectContainer* Container = Cast<UGameObjectContainer>(Object);
+		if (Container)
+		{
+			FGameObjectLinkRecord LinkRecord;
+			LinkRecord.ParentIndex = RecordIndex;
+			LinkRecord.ChildIndices.Reserve( Container->ChildSlots.Num() );
+			for (const FGameObjectSlot& Slot : Container->ChildSlots)
+			{
+				UGameObject* Child = Slot.Object;
+				if (Child)
+				{
+					LinkRecord.ChildIndices.Add( RecordIndices.FindChecked( Child ) );
+					Trace("   Link Parent( %s ) -> Child( %s )", *Container->GetFullName(), *Child->GetFullName() );
+				}
+			}
+			OutTreeRecord.LinkRecords.Add(LinkRecord);
+		}
+	}
+
+	// Record my Links
+	OutTreeRecord.LinkRecords.Add(MyLinkRecord);
+	INC_DWORD_STAT_BY( STAT_GameModules_RecordsSerialized, OutTreeRecord.ObjectRecords.Num() );
+
+	// Serialize my data
+	FMemoryWriter Writer(OutTreeRecord.ByteData);
+	FSaveGameArchive Ar(Writer);
+	UObject* Self = (UObject*) this;
+	Self->Serialize(Ar);
+
+	Trace("Saving ended.");
+	return true;
+
+}
+
+/** Find the object recreated from a record, null if the index is out of range or the record failed to load. */
+static UGameObject* FindRecordObject( const TArray<UGameObject*>& RecordObjects, int32 RecordIndex )
+{
+	return RecordObjects.IsValidIndex( RecordIndex ) ? RecordObjects[RecordIndex] : nullptr;
+}
+
+/** Convert the name based links of a record older than IndexedLinks to indexed links. */
+static void ConvertNamedLinks( const FGameObjectTreeRecord& InTreeRecord, TArray<FGameObjectLinkRecord>& OutLinkRecords )
+{
+	TMap<FName, int32> RecordIndicesByName;
+	RecordIndicesByName.Reserve( InTreeRecord.ObjectRecords.Num() );
+	for ( int32 RecordIndex = 0; RecordIndex < InTreeRecord.ObjectRecords.Num(); RecordIndex++ )
+	{
+		const FName& Name = InTreeRecord.ObjectRecords[RecordIndex].Name;
+		if ( !Name.IsNone() )
+		{
+			RecordIndicesByName.Add( Name, RecordIndex );
+		}
+	}
+
+	// INDEX_NONE stands for the tree, so unknown names map to an index that is never valid and fail to link like before.
+	auto FindRecordIndex = [&RecordIndicesByName]( const FName& Name )
+	{
+		const int32* pRecordIndex = RecordIndicesByName.Find( Name );
+		return pRecordIndex ? *pRecordIndex : MAX_int32;
+	};
+
+	OutLinkRecords.Reset( InTreeRecord.LinkRecords.Num() );
+	for ( const FGameObjectLinkRecord& NamedLinkRecord : InTreeRecord.LinkRecords )
+	{
+		FGameObjectLinkRecord& LinkRecord = OutLinkRecords[OutLinkRecords.AddDefaulted()];
+		LinkRecord.ParentIndex = NamedLinkRecord.ParentName.IsNone() ? INDEX_NONE : FindRecordIndex( NamedLinkRecord.ParentName );
+		LinkRecord.ChildIndices.Reserve( NamedLinkRecord.ChildNames.Num() );
+		for ( const FName& ChildName : NamedLinkRecord.ChildNames )
+		{
+			LinkRecord.ChildIndices.Add( FindRecordIndex( ChildName ) );
+		}
+	}
+}
+
+bool UGameObjectTree::LoadFromRecord( const FGameObjectTreeRecord& InRecord )
+{
+	return LoadFromRecord_Internal( InRecord, nullptr );
+}
+
+bool UGameObjectTree::LoadFromRecord( const FGameObjectTreeRecord& InRecord, const TArray<FName>& InSubtreeIDs )
+{
+	return LoadFromRecord_Internal( InRecord, &InSubtreeIDs );
+}
+
+bool UGameObjectTree::LoadFromRecord_Internal( const FGameObjectTreeRecord& InTreeRecord, const TArray<FName>* InSubtreeIDs )
+{
+	SCOPE_CYCLE_COUNTER( STAT_GameModules_LoadFromRecord );
+
+	// The objects of the save in progress are about to be replaced.
+	CancelIncrementalSave();
+	ResetDeferredSubtrees();
+
+	// Recreating the objects is not a change, tracking resumes against the loaded record.
+	ResetSaveDirtyState( FGuid() );
+
+	if ( InTreeRecord.PackedData.Num() > 0 )
+	{
+		bool bSuccess;
+		if ( InTreeRecord.Deltas.Num() > 0 )
+		{
+			TArray<uint8> MergedData;
+			if ( !FPackedTreeRecordWriter::MergeDeltas( InTreeRecord.PackedData, InTreeRecord.Deltas, MergedData ) )
+			{
+				PrintLogError( "Corrupt packed tree record" );
+				return false;
+			}
+			bSuccess = LoadFromPackedRecord( MergedData, InSubtreeIDs );
+		}
+		else
+		{
+			bSuccess = LoadFromPackedRecord( InTreeRecord.PackedData, InSubtreeIDs );
+		}
+
+		if ( bSuccess && InTreeRecord.BaseID.IsValid() )
+		{
+			ResetSaveDirtyState( InTreeRecord.BaseID );
+		}
+		return bSuccess;
+	}
+
+	UObject* Outer = (UObject*) GetTransientPackage();
+
+	bool bHasError = false;
+
+	RemoveChildren( true );
+
+	// Objects by the index of the record they are recreated from, null for the records that fail to load.
+	TArray<UGameObject*> RecordObjects;
+	RecordObjects.AddZeroed( InTreeRecord.ObjectRecords.Num() );
+
+	// Recreate game objects
+	for ( int32 RecordIndex = 0; RecordIndex < InTreeRecord.ObjectRecords.Num(); RecordIndex++ )
+	{
+		const FGameObjectRecord& ObjectRecord = InTreeRecord.ObjectRecords[RecordIndex];
+
+		// Make sure record is valid
+		if (!ObjectRecord.Class || ObjectRecord.Name.IsNone())
+		{
+			PrintLogError( "Corrupt Object's Record: Class='%s', Name='%s'", *GetFullNameSafe(ObjectRecord.Class), *ObjectRecord.Name.ToString() );
+			bHasError = true;
+			continue;
+		}
+
+		// Create object
+		UGameObject* Object = NewObject<UGameObject>( Outer, ObjectRecord.Class, ObjectRecord.Name);
+		if (!Object)
+		{
+			PrintLogError( "Fail to create Object: Class='%s', Name='%s'" , *GetFullNameSafe(ObjectRecord.Class), *ObjectRecord.Name.ToString() );
+			bHasError = true;
+			continue;
+		}
+
+		// retrieve ID
+		Object->ID = ObjectRecord.ID.IsEmpty() ? NAME_None : FName( *ObjectRecord.ID );
+
+		// Make sure it's not garbage collected
+		Object->AddToRoot();		
+
+		// Keep it for the last loading phase of data serialization.
+		RecordObjects[RecordIndex] = Object;
+		Trace( "Recreate Object : %s", *Object->GetFullName() );
+	}
+
+	// Older records link objects by name, resolve the names once so the links below are all indexed.
+	TArray<FGameObjectLinkRecord> ConvertedLinkRecords;
+	if ( InTreeRecord.Version < EGameObjectRecordVersion::IndexedLinks )
+	{
+		ConvertNamedLinks( InTreeRecord, ConvertedLinkRecords );
+	}
+	const TArray<FGameObjectLinkRecord>& LinkRecords = InTreeRecord.Version < EGameObjectRecordVersion::IndexedLinks ? ConvertedLinkRecords : InTreeRecord.LinkRecords;
+
+	// Rebuild Links
+	for (const FGameObjectLinkRecord& LinkRecord : LinkRecords)
+	{
+		UGameObjectContainer* Parent;
+		if ( LinkRecord.ParentIndex == INDEX_NONE )
+		{
+			Parent = Cast<UGameObjectContainer>( this );
+		}
+		else
+		{
+			Parent = Cast<UGameObjectContainer>( FindRecordObject( RecordObjects, LinkRecord.ParentIndex ) );
+		}
+
+		if ( !Parent )
+		{
+			PrintLogError( "Parent is not a container" );
+			bHasError = true;
+			continue;
+		}
+
+		for ( int32 ChildIndex : LinkRecord.ChildIndices )
+		{
+			UGameObject* Child = FindRecordObject( RecordObjects, ChildIndex );
+			if ( !Child )
+			{
+				PrintLogError( "Child is not a game object" );
+				bHasError = true;
+				continue;
+			}
+
+			Child->Parent = Parent;
+			Parent->AllocateChildSlot( Child );
+			bIsIntervalNumberingValid = false;
+			Trace( "[%s] Parent: (%s) -> [%s] Child (%s)", *Parent->GetID(), *Parent->GetPathName(), *Child->GetID(), *Child->GetPathName() );
+		}
+	}
+
+	// The links are complete, let every object know its tree and depth, and count its tree event listeners in.
+	for ( const FGameObjectSlot& Slot : ChildSlots )
+	{
+		if ( Slot.Object )
+		{
+			AdjustTreeEventListeners( SetObjectTreeAndDepth( Slot.Object, this, 1 ) );
+		}
+	}
+
+	// Serialize objects
+	for ( int32 RecordIndex = 0; RecordIndex < RecordObjects.Num(); RecordIndex++ )
+	{
+		UGameObject* Object = RecordObjects[RecordIndex];
+		if ( !Object )
+		{
+			continue;
+		}
+
+		FMemoryReader MemoryReader(InTreeRecord.ObjectRecords[RecordIndex].ByteData);
+		FSaveGameArchive Ar(MemoryReader);
+		Object->Serialize(Ar);
+
+		// It's now okay to remove it from ''root''.
+		Object->RemoveFromRoot();
+	}
+	INC_DWORD_STAT_BY( STAT_GameModules_RecordsSerialized, InTreeRecord.ObjectRecords.Num() );
+
+	// Serialize self
+	FMemoryReader MemoryReader(InTreeRecord.ByteData);
+	FSaveGameArchive Ar(MemoryReader);
+	this->Serialize(Ar);
+
+	// Tick flags have just been restored, register the loaded objects to the tick lists.
+	RebuildTickLists();
+
+	return bHasError == false;
+}
+
+
+void UGameObjectTree::PackSubtree_Recursive( FPackedTreeRecordWriter& Writer, UGameObject* Object, int32 ParentIndex )
+{
+	const int32 Index = Writer.AddObject( Object, ParentIndex );
+	Trace( "    Pack Object: %s", *Object->GetFullName() );
+
+	UGameObjectContainer* Container = Cast<UGameObjectContainer>( Object );
+	if ( Container )
+	{
+		for ( const FGameObjectSlot& Slot : Container->ChildSlots )
+		{
+			if ( Slot.Object )
+			{
+				PackSubtree_Recursive( Writer, Slot.Object, Index );
+			}
+		}
+	}
+}
+
+void UGameObjectTree::SaveToPackedRecord( TArray<uint8>& OutPackedData ) const
+{
+	FPackedTreeRecordWriter Writer;
+
+	// Depth first, so every parent is packed before its children and the children keep their slot order.
+	for ( const FGameObjectSlot& Slot : ChildSlots )
+	{
+		if ( Slot.Object )
+		{
+			PackSubtree_Recursive( Writer, Slot.Object, INDEX_NONE );
+		}
+	}
+	PackDeferredSubtrees( Writer );
+
+	Writer.SetTreeData( (UObject*) this );
+	Writer.Finish( OutPackedData );
+}
+
+bool UGameObjectTree::LoadFromPackedRecord( const TArray<uint8>& InPackedData, const TArray<FName>* InSubtreeIDs )
+{
+	// A partial load reads the deferred children in place later on, so it keeps its own copy of the record.
+	TSharedPtr<FGameObjectDeferredRecord> Record = MakeShareable( new FGameObjectDeferredRecord() );
+	if ( InSubtreeIDs )
+	{
+		Record->Data = InPackedData;
+	}
+	const TArray<uint8>& Data = InSubtreeIDs ? Record->Data : InPackedData;
+
+	FPackedTreeRecordReader& Reader = Record->Reader;
+	if ( !Reader.Open( Data.GetData(), Data.Num() ) )
+	{
+		PrintLogError( "Corrupt packed tree record" );
+		return false;
+	}
+
+	bool bHasError = false;
+
+	RemoveChildren( true );
+
+	TSet<FName> SubtreeIDs;
+	if ( InSubtreeIDs )
+	{
+		SubtreeIDs.Append( *InSubtreeIDs );
+	}
+
+	// Each child of the tree is a block of its own, the blocks that are not requested are left in the record.
+	TArray<int32> BlockIndices;
+	BlockIndices.Reserve( Reader.GetNumBlocks() );
+	for ( int32 BlockIndex = 0; BlockIndex < Reader.GetNumBlocks(); BlockIndex++ )
+	{
+		const FPackedSubtreeBlock& Block = Reader.GetBlock( BlockIndex );
+		const FPackedObjectEntry& Entry = Reader.GetEntry( Block.FirstEntry );
+		const FName ID = Reader.GetID( Entry );
+		if ( !InSubtreeIDs || SubtreeIDs.Contains( ID ) )
+		{
+			BlockIndices.Add( BlockIndex );
+			continue;
+		}
+
+		if ( !ID.IsNone() )
+		{
+			DeferredSubtreeIndicesByID.Add( ID, DeferredSubtrees.Num() );
+		}
+		FGameObjectDeferredSubtree& Subtree = DeferredSubtrees[ DeferredSubtrees.AddDefaulted() ];
+		Subtree.BlockIndex = BlockIndex;
+		Subtree.Name = Reader.GetName( Entry );
+		Subtree.ID = ID;
+		Subtree.Class = Reader.GetClass( Entry );
+		for ( int32 EntryIndex = Block.FirstEntry + 1; EntryIndex < Block.FirstEntry + Block.NumEntries; EntryIndex++ )
+		{
+			const FPackedObjectEntry& Descendant = Reader.GetEntry( EntryIndex );
+			if ( UClass* Class = Reader.GetClass( Descendant ) )
+			{
+				Subtree.DescendantClasses.AddUnique( Class );
+			}
+			if ( Descendant.IDIndex != INDEX_NONE )
+			{
+				Subtree.DescendantIDs.Add( Reader.GetID( Descendant ) );
+			}
+		}
+	}
+
+	TArray<UGameObject*> Objects;
+	if ( !LoadPackedBlocks( Reader, BlockIndices, Objects ) )
+	{
+		bHasError = true;
+	}
+
+	// Serialize self
+	if ( !Reader.SerializeTree( this ) )
+	{
+		PrintLogError( "Fail to load the object tree data" );
+		bHasError = true;
+	}
+
+	// Tick flags have just been restored, register the loaded objects to the tick lists.
+	RebuildTickLists();
+
+	if ( DeferredSubtrees.Num() > 0 )
+	{
+		ReserveDeferredNames( Reader );
+		DeferredRecord = Record;
+		Trace( "Deferred %d of %d subtrees.", DeferredSubtrees.Num(), Reader.GetNumBlocks() );
+	}
+
+	return bHasError == false;
+}
+
+bool UGameObjectTree::LoadPackedBlocks( const FPackedTreeRecordReader& Reader, const TArray<int32>& BlockIndices, TArray<UGameObject*>& OutObjects )
+{
+	UObject* Outer = (UObject*) GetTransientPackage();
+
+	bool bHasError = false;
+
+	for ( int32 BlockIndex : BlockIndices )
+	{
+		const FPackedSubtreeBlock& Block = Reader.GetBlock( BlockIndex );
+
+		// Objects by the index of their entry in the block, null for the entries that fail to load.
+		TArray<UGameObject*> BlockObjects;
+		BlockObjects.AddZeroed( Block.NumEntries );
+
+		// Recreate and link game objects, the parents always come before their children.
+		for ( int32 Index = 0; Index < Block.NumEntries; Index++ )
+		{
+			const FPackedObjectEntry& Entry = Reader.GetEntry( Block.FirstEntry + Index );
+
+			UClass* Class = Reader.GetClass( Entry );
+			if ( !Class || !Class->IsChildOf( UGameObject::StaticClass() ) )
+			{
+				PrintLogError( "Object's class is not a game object class: Class='%s', Name='%s'", *Reader.GetClassPath( Entry ), *Reader.GetString( Entry.NameIndex ) );
+				bHasError = true;
+				continue;
+			}
+
+			// Deferred objects are created long after the load, another object may have taken the name by then.
+			// Creating an object under a name in use replaces that object, so it gets a name of its own and keeps the saved one for the records.
+			const FName Name = Reader.GetName( Entry );
+			const bool bIsNameTaken = StaticFindObjectFast( nullptr, Outer, Name ) != nullptr;
+
+			UGameObject* Object = NewObject<UGameObject>( Outer, Class, bIsNameTaken ? MakeUniqueObjectName( Outer, Class ) : Name );
+			if ( !Object )
+			{
+				PrintLogError( "Fail to create Object: Class='%s', Name='%s'", *Reader.GetClassPath( Entry ), *Reader.GetString( Entry.NameIndex ) );
+				bHasError = true;
+				continue;
+			}
+
+			Object->ID = Reader.GetID( Entry );
+			Object->SaveName = bIsNameTaken ? Name : NAME_None;
+
+			// Make sure it's not garbage collected
+			Object->AddToRoot();
+			BlockObjects[Index] = Object;
+
+			UGameObjectContainer* Parent = ( Entry.ParentIndex == INDEX_NONE ) ? this : Cast<UGameObjectContainer>( BlockObjects[Entry.ParentIndex - Block.FirstEntry] );
+			if ( !Parent )
+			{
+				PrintLogError( "Parent is not a container" );
+				bHasError = true;
+				continue;
+			}
+
+			Object->Parent = Parent;
+			Parent->AllocateChildSlot( Object );
+			Trace( "Recreate Object : %s", *Object->GetFullName() );
+		}
+
+		// The links are complete, let every object know its tree and depth, and count its tree event listeners in.
+		UGameObject* Root = BlockObjects[0];
+		if ( Root )
+		{
+			AdjustTreeEventListeners( SetObjectTreeAndDepth( Root, this, 1 ) );
+		}
+
+		// Serialize objects
+		for ( int32 Index = 0; Index < Block.NumEntries; Index++ )
+		{
+			UGameObject* Object = BlockObjects[Index];
+			if ( !Object )
+			{
+				continue;
+			}
+
+			if ( !Reader.SerializeObject( Reader.GetEntry( Block.FirstEntry + Index ), Object ) )
+			{
+				PrintLogError( "Fail to load Object: %s", *Object->GetFullName() );
+				bHasError = true;
+			}
+
+			// It's now okay to remove it from ''root''.
+			Object->RemoveFromRoot();
+			OutObjects.Add( Object );
+		}
+		INC_DWORD_STAT_BY( STAT_GameModules_RecordsSerialized, Block.NumEntries );
+	}
+	bIsIntervalNumberingValid = false;
+
+	return bHasError == false;
+}
+
+UGameObject* UGameObjectTree::LoadDeferredSubtree( FName InID )
+{
+	if ( InID.IsNone() )
+	{
+		return nullptr;
+	}
+
+	LoadDeferredSubtrees( nullptr, InID, false );
+	return FindChildByID( InID );
+}
+
+void UGameObjectTree::LoadAllDeferredSubtrees()
+{
+	LoadDeferredSubtrees( nullptr, NAME_None, false );
+}
+
+int32 UGameObjectTree::GetNumDeferredSubtrees() const
+{
+	return DeferredSubtrees.Num();
+}
+
+bool UGameObjectTree::RemoveDeferredSubtree( FName InID )
+{
+	const int32* pIndex = DeferredSubtreeIndicesByID.Find( InID );
+	if ( !pIndex )
+	{
+		return false;
+	}
+
+	DeferredSubtrees.RemoveAt( *pIndex );
+	RebuildDeferredSubtreeIndices();
+	if ( DeferredSubtrees.Num() == 0 )
+	{
+		DeferredRecord.Reset();
+	}
+
+	// The delta merge drops the objects that are not reachable from the children of this tree anymore.
+	NoteSaveChildrenChanged( this );
+	return true;
+}
+
+bool UGameObjectTree::IsSubtreeDeferred( const FName& InID ) const
+{
+	return DeferredSubtreeIndicesByID.Contains( InID );
+}
+
+void UGameObjectTree::RebuildDeferredSubtreeIndices()
+{
+	DeferredSubtreeIndicesByID.Reset();
+	for ( int32 Index = 0; Index < DeferredSubtrees.Num(); Index++ )
+	{
+		if ( !DeferredSubtrees[Index].ID.IsNone() )
+		{
+			DeferredSubtreeIndicesByID.Add( DeferredSubtrees[Index].ID, Index );
+		}
+	}
+}
+
+int32 UGameObjectTree::LoadDeferredSubtrees( UClass* InClass, const FName& InID, bool bRecursive )
+{
+	// Objects can only be created on the game thread and outside of the thread safe subtrees, the thread is checked before anything else is read.
+	if ( !IsInGameThread() || IsSimulatingThreadSafeSubtree() || DeferredSubtrees.Num() == 0 )
+	{
+		return 0;
+	}
+
+	// The record is released once nothing is deferred anymore, keep it alive until the objects are loaded.
+	TSharedPtr<FGameObjectDeferredRecord> Record = DeferredRecord;
+	const FPackedTreeRecordReader& Reader = Record->Reader;
+
+	auto IsOfClass = [InClass]( const UClass* Class )
+	{
+		return Class && Class->IsChildOf( InClass );
+	};
+	auto Matches = [&]( const FGameObjectDeferredSubtree& Subtree )
+	{
+		const bool bClassMatches = !InClass || IsOfClass( Subtree.Class ) || ( bRecursive && Subtree.DescendantClasses.ContainsByPredicate( IsOfClass ) );
+		const bool bIDMatches = InID.IsNone() || Subtree.ID == InID || ( bRecursive && Subtree.DescendantIDs.Contains( InID ) );
+		return bClassMatches && bIDMatches;
+	};
+
+	// A lookup of a child by ID can only match the deferred child with that ID.
+	if ( !InID.IsNone() && !bRecursive )
+	{
+		const int32* pIndex = DeferredSubtreeIndicesByID.Find( InID );
+		if ( !pIndex || !Matches( DeferredSubtrees[*pIndex] ) )
+		{
+			return 0;
+		}
+	}
+
+	// Taken out of the deferred children before they are loaded, so a lookup while loading does not load them again.
+	TArray<int32> BlockIndices;
+	DeferredSubtrees.RemoveAll( [&]( const FGameObjectDeferredSubtree& Subtree )
+	{
+		if ( Matches( Subtree ) )
+		{
+			BlockIndices.Add( Subtree.BlockIndex );
+			return true;
+		}
+		return false;
+	} );
+
+	if ( BlockIndices.Num() == 0 )
+	{
+		return 0;
+	}
+	RebuildDeferredSubtreeIndices();
+
+	SCOPE_CYCLE_COUNTER( STAT_GameModules_LoadFromRecord );
+
+	// Loading is not a change, the objects are already in the record the changes are tracked against.
+	const bool bWasSaveChildrenDirty = bSaveChildrenDirty;
+
+	TArray<UGameObject*> Objects;
+	if ( !LoadPackedBlocks( Reader, BlockIndices, Objects ) )
+	{
+		PrintLogError( "Fail to load some of the deferred objects" );
+	}
+
+	for ( UGameObject* Object : Objects )
+	{
+		Object->bSaveDirty = false;
+	}
+	SaveDirtyObjects.RemoveAll( []( UGameObject* Object )
+	{
+		return !Object || !Object->bSaveDirty;
+	} );
+	bSaveChildrenDirty = bWasSaveChildrenDirty;
+
+	// Tick flags have just been restored, register the loaded children like the children loaded with the tree.
+	for ( UGameObject* Object : Objects )
+	{
+		if ( Object->GetParent() == this )
+		{
+			RegisterSubtree( Object );
+		}
+	}
+
+	if ( DeferredSubtrees.Num() == 0 )
+	{
+		DeferredRecord.Reset();
+	}
+
+	Trace( "Loaded %d deferred subtrees, %d are left.", BlockIndices.Num(), DeferredSubtrees.Num() );
+	return BlockIndices.Num();
+}
+
+void UGameObjectTree::PackDeferredSubtrees( FPackedTreeRecordWriter& Writer ) const
+{
+	if ( DeferredSubtrees.Num() == 0 )
+	{
+		return;
+	}
+
+	// The data is copied as is, the objects of each block keep their order so the parents are offset by the same amount.
+	const FPackedTreeRecordReader& Reader = DeferredRecord->Reader;
+	for ( const FGameObjectDeferredSubtree& Subtree : DeferredSubtrees )
+	{
+		const FPackedSubtreeBlock& Block = Reader.GetBlock( Subtree.BlockIndex );
+
+		int32 RootIndex = INDEX_NONE;
+		for ( int32 EntryIndex = Block.FirstEntry; EntryIndex < Block.FirstEntry + Block.NumEntries; EntryIndex++ )
+		{
+			const FPackedObjectEntry& Entry = Reader.GetEntry( EntryIndex );
+			const int32 ParentIndex = ( Entry.ParentIndex == INDEX_NONE ) ? INDEX_NONE : RootIndex + ( Entry.ParentIndex - Block.FirstEntry );
+			const int32 Index = Writer.AddPackedObject( Reader.GetClassPath( Entry ), &Reader.GetClassLayout( Entry ), Reader.GetName( Entry ), Reader.GetID( Entry ),
+				ParentIndex, Reader.GetObjectData( Entry ), Entry.PayloadSize );
+			if ( RootIndex == INDEX_NONE )
+			{
+				RootIndex = Index;
+			}
+		}
+	}
+}
+
+void UGameObjectTree::ReserveDeferredNames( const FPackedTreeRecordReader& Reader ) const
+{
+	for ( const FGameObjectDeferredSubtree& Subtree : DeferredSubtrees )
+	{
+		const FPackedSubtreeBlock& Block = Reader.GetBlock( Subtree.BlockIndex );
+		for ( int32 EntryIndex = Block.FirstEntry; EntryIndex < Block.FirstEntry + Block.NumEntries; EntryIndex++ )
+		{
+			const FPackedObjectEntry& Entry = Reader.GetEntry( EntryIndex );
+			UClass* Class = Reader.GetClass( Entry );
+			const FName Name = Reader.GetName( Entry );
+
+			// Generated names are the class name with a number that only goes up, see MakeUniqueObjectName.
+			if ( Class && Name.GetComparisonIndex() == Class->GetFName().GetComparisonIndex() )
+			{
+				Class->ClassUnique = FMath::Max<int32>( Class->ClassUnique, Name.GetNumber() + 1 );
+			}
+		}
+	}
+}
+
+void UGameObjectTree::ResetDeferredSubtrees()
+{
+	DeferredSubtrees.Empty();
+	DeferredSubtreeIndicesByID.Empty();
+	DeferredRecord.Reset();
+}
+
+bool UGameObjectTree::BeginIncrementalSave( float BudgetSeconds, const FOnGameObjectTreeSaved& OnSaved )
+{
+	if ( SaveCapture.IsActive() )
+	{
+		PrintLogError( "An incremental save is already in progress" );
+		return false;
+	}
+
+	// Only the structure is taken now, it is cheap compared to serializing the objects.
+	for ( const FGameObjectSlot& Slot : ChildSlots )
+	{
+		if ( Slot.Object )
+		{
+			CollectSaveCapture_Recursive( Slot.Object, INDEX_NONE );
+		}
+	}
+
+#if !UE_BUILD_SHIPPING
+	if ( GVerifyIncrementalSave )
+	{
+		// Serialized the same way as they will be captured, only the CRCs are kept.
+		FPackedTreeRecordWriter VerifyWriter;
+		SaveCapture.BeginDataCrcs.Reserve( SaveCapture.Objects.Num() );
+		for ( UGameObject* Object : SaveCapture.Objects )
+		{
+			SaveCapture.BeginDataCrcs.Add( VerifyWriter.GetObjectDataCrc( VerifyWriter.AddObject( Object, INDEX_NONE ) ) );
+		}
+	}
+#endif
+
+	SaveCapture.Writer = MakeShareable( new FPackedTreeRecordWriter() );
+	SaveCapture.Writer->SetNumObjects( SaveCapture.Objects.Num() );
+	PackDeferredSubtrees( *SaveCapture.Writer );
+	SaveCapture.Writer->SetTreeData( this );
+	SaveCapture.Cursor = 0;
+	SaveCapture.BudgetSeconds = BudgetSeconds;
+	SaveCapture.OnSaved = OnSaved;
+
+	Trace( "Begin incremental save of %d objects.", SaveCapture.Objects.Num() );
+	return true;
+}
+
+void UGameObjectTree::FinishIncrementalSave()
+{
+	if ( SaveCapture.IsActive() )
+	{
+		SaveCapture.BudgetSeconds = 0.0f;
+		ContinueIncrementalSave();
+	}
+}
+
+void UGameObjectTree::CancelIncrementalSave()
+{
+	if ( SaveCapture.IsActive() )
+	{
+		CompleteIncrementalSave( false );
+	}
+}
+
+void UGameObjectTree::CollectSaveCapture_Recursive( UGameObject* Object, int32 ParentIndex )
+{
+	const int32 Index = SaveCapture.Objects.Add( Object );
+	SaveCapture.ParentIndices.Add( ParentIndex );
+	Object->SaveCaptureIndex = Index;
+
+	UGameObjectContainer* Container = Cast<UGameObjectContainer>( Object );
+	if ( Container )
+	{
+		for ( const FGameObjectSlot& Slot : Container->ChildSlots )
+		{
+			if ( Slot.Object )
+			{
+				CollectSaveCapture_Recursive( Slot.Object, Index );
+			}
+		}
+	}
+}
+
+void UGameObjectTree::ContinueIncrementalSave()
+{
+	SCOPE_CYCLE_COUNTER( STAT_GameModules_SaveToRecord );
+
+	const bool bHasBudget = SaveCapture.BudgetSeconds > 0.0f;
+	const double EndTime = FPlatformTime::Seconds() + SaveCapture.BudgetSeconds;
+
+	// The objects that have been captured out of order are already cleared and skipped.
+	const int32 NumObjects = SaveCapture.Objects.Num();
+	while ( SaveCapture.Cursor < NumObjects )
+	{
+		UGameObject* Object = SaveCapture.Objects[SaveCapture.Cursor++];
+		if ( Object )
+		{
+			CaptureForSave_Internal( Object );
+			if ( bHasBudget && FPlatformTime::Seconds() >= EndTime )
+			{
+				break;
+			}
+		}
+	}
+
+	if ( SaveCapture.Cursor >= NumObjects )
+	{
+		CompleteIncrementalSave( true );
+	}
+}
+
+void UGameObjectTree::CaptureForSave_Internal( UGameObject* Object )
+{
+	const int32 Index = Object->SaveCaptureIndex;
+	check( SaveCapture.Objects.IsValidIndex( Index ) && SaveCapture.Objects[Index] == Object );
+
+	SaveCapture.Writer->SetObject( Index, Object, SaveCapture.ParentIndices[Index] );
+	SaveCapture.Objects[Index] = nullptr;
+
+#if !UE_BUILD_SHIPPING
+	// Every capture happens before the object is changed, unless something has changed it without calling CaptureForSave.
+	if ( SaveCapture.BeginDataCrcs.IsValidIndex( Index ) && SaveCapture.BeginDataCrcs[Index] != SaveCapture.Writer->GetObjectDataCrc( Index ) )
+	{
+		PrintLogError( "%s has been changed during an incremental save without CaptureForSave, the save has a torn snapshot of it", *Object->GetPathName() );
+	}
+#endif
+	Object->SaveCaptureIndex = INDEX_NONE;
+	INC_DWORD_STAT( STAT_GameModules_RecordsSerialized );
+}
+
+void UGameObjectTree::CaptureSubtreeForSave( UGameObject* Object )
+{
+	CaptureForSave( Object );
+
+	UGameObjectContainer* Container = Cast<UGameObjectContainer>( Object );
+	if ( Container )
+	{
+		for ( const FGameObjectSlot& Slot : Container->ChildSlots )
+		{
+			if ( Slot.Object )
+			{
+				CaptureSubtreeForSave( Slot.Object );
+			}
+		}
+	}
+}
+
+void UGameObjectTree::CompleteIncrementalSave( bool bSuccess )
+{
+	// An object that has been destroyed before it has been captured leaves its entry unset, the record would not load.
+	if ( bSuccess )
+	{
+		const int32 NumUnset = SaveCapture.Writer->GetNumUnsetObjects();
+		if ( NumUnset > 0 )
+		{
+			PrintLogError( "Incremental save failed, %d objects have been destroyed before they have been captured", NumUnset );
+			bSuccess = false;
+		}
+	}
+
+	FGameObjectTreeRecord Record;
+	if ( bSuccess )
+	{
+		Record.Version = EGameObjectRecordVersion::Latest;
+		SaveCapture.Writer->Finish( Record.PackedData );
+		Trace( "Incremental save ended, packed %d bytes.", Record.PackedData.Num() );
+	}
+	else
+	{
+		for ( UGameObject* Object : SaveCapture.Objects )
+		{
+			if ( Object )
+			{
+				Object->SaveCaptureIndex = INDEX_NONE;
+			}
+		}
+		Trace( "Incremental save cancelled." );
+	}
+
+	// Reset before calling the delegate, so it can begin another save.
+	FOnGameObjectTreeSaved OnSaved = SaveCapture.OnSaved;
+	SaveCapture = FGameObjectSaveCapture();
+
+	OnSaved.ExecuteIfBound( bSuccess, Record );
+}
+
+bool UGameObjectTree::SaveDeltaToRecord( FGameObjectTreeRecord& InOutRecord )
+{
+	// Deltas only apply on top of the record the changes have been tracked against.
+	if ( !SaveBaseID.IsValid() || InOutRecord.BaseID != SaveBaseID || InOutRecord.PackedData.Num() == 0 )
+	{
+		return SaveBaseToRecord( InOutRecord );
+	}
+
+	SCOPE_CYCLE_COUNTER( STAT_GameModules_SaveToRecord );
+
+	FGameObjectTreeDeltaRecord& Delta = InOutRecord.Deltas[ InOutRecord.Deltas.AddDefaulted() ];
+	Delta.RemovedNames = SaveRemovedNames.Array();
+	Delta.ObjectRecords.Reserve( SaveDirtyObjects.Num() );
+
+	for ( UGameObject* Object : SaveDirtyObjects )
+	{
+		// Objects that have left this tree since they have been marked are in the removed names instead.
+		if ( !Object || !Object->bSaveDirty || Object->OwningTree != this )
+		{
+			continue;
+		}
+		Object->bSaveDirty = false;
+
+		FGameObjectDeltaRecord& ObjectRecord = Delta.ObjectRecords[ Delta.ObjectRecords.AddDefaulted() ];
+		ObjectRecord.ClassPath = Object->GetClass()->GetPathName();
+		ObjectRecord.Name = Object->GetSaveName();
+		ObjectRecord.ID = Object->ID;
+
+		FMemoryWriter Writer( ObjectRecord.ByteData );
+		FSaveGameArchive Ar( Writer );
+		Object->Serialize( Ar );
+
+		if ( UGameObjectContainer* Container = Cast<UGameObjectContainer>( Object ) )
+		{
+			ObjectRecord.bHasChildren = true;
+			GetSaveChildNames( Container, ObjectRecord.ChildNames );
+		}
+		Trace( "    Save Delta Object: %s", *Object->GetFullName() );
+	}
+	INC_DWORD_STAT_BY( STAT_GameModules_RecordsSerialized, Delta.ObjectRecords.Num() );
+
+	// The data of the tree itself is small, it is always saved.
+	{
+		FMemoryWriter Writer( Delta.ByteData );
+		FSaveGameArchive Ar( Writer );
+		Serialize( Ar );
+	}
+
+	if ( bSaveChildrenDirty )
+	{
+		Delta.bHasChildren = true;
+		GetSaveChildNames( this, Delta.ChildNames );
+
+		// The deferred children are still children of this tree.
+		for ( const FGameObjectDeferredSubtree& Subtree : DeferredSubtrees )
+		{
+			Delta.ChildNames.Add( Subtree.Name );
+		}
+	}
+
+	InOutRecord.Version = EGameObjectRecordVersion::Latest;
+	ResetSaveDirtyState( SaveBaseID );
+	Trace( "Saved delta %d: %d objects, %d removed.", InOutRecord.Deltas.Num(), Delta.ObjectRecords.Num(), Delta.RemovedNames.Num() );
+
+	if ( MaxSaveDeltas < 0 || InOutRecord.Deltas.Num() <= MaxSaveDeltas )
+	{
+		return true;
+	}
+
+	// Compact, the merged record gets another ID so copies of the record from before can not be saved on top of anymore.
+	TArray<uint8> MergedData;
+	if ( !FPackedTreeRecordWriter::MergeDeltas( InOutRecord.PackedData, InOutRecord.Deltas, MergedData ) )
+	{
+		PrintLogError( "Fail to merge the deltas, doing a full save instead" );
+		return SaveBaseToRecord( InOutRecord );
+	}
+	InOutRecord.PackedData = MoveTemp( MergedData );
+	InOutRecord.Deltas.Empty();
+	InOutRecord.BaseID = FGuid::NewGuid();
+	SaveBaseID = InOutRecord.BaseID;
+	Trace( "Merged the deltas, packed %d bytes.", InOutRecord.PackedData.Num() );
+
+	return true;
+}
+
+bool UGameObjectTree::SaveBaseToRecord( FGameObjectTreeRecord& OutRecord )
+{
+	SCOPE_CYCLE_COUNTER( STAT_GameModules_SaveToRecord );
+
+	// Deltas are merged at the byte level, so the base is always packed regardless of bPackRecords.
+	OutRecord.Version = EGameObjectRecordVersion::Latest;
+	OutRecord.ObjectRecords.Empty();
+	OutRecord.LinkRecords.Empty();
+	OutRecord.ByteData.Empty();
+	OutRecord.Deltas.Empty();
+	OutRecord.PackedData.Empty();
+	SaveToPackedRecord( OutRecord.PackedData );
+
+	OutRecord.BaseID = FGuid::NewGuid();
+	ResetSaveDirtyState( OutRecord.BaseID );
+	Trace( "Saved the delta base, packed %d bytes.", OutRecord.PackedData.Num() );
+	return true;
+}
+
+void UGameObjectTree::NoteSaveDirty( UGameObject* Object )
+{
+	if ( Object->bSaveDirty || Object == this || !SaveBaseID.IsValid() )
+	{
+		return;
+	}
+
+	// Only the simulating thread touches the objects of a thread safe subtree, so its own list needs no lock.
+	Object->bSaveDirty = true;
+	if ( TArray<UGameObject*>* SubtreeDirtyObjects = (TArray<UGameObject*>*) FPlatformTLS::GetTlsValue( ThreadSafeSimulationTlsSlot ) )
+	{
+		SubtreeDirtyObjects->Add( Object );
+	}
+	else
+	{
+		SaveDirtyObjects.Add( Object );
+	}
+}
+
+void UGameObjectTree::NoteSaveRemoved( UGameObject* Object )
+{
+	if ( !SaveBaseID.IsValid() )
+	{
+		return;
+	}
+
+	// Still listed in the dirty objects, but it is skipped since it is no longer in this tree.
+	Object->bSaveDirty = false;
+	SaveRemovedNames.Add( Object->GetSaveName() );
+}
+
+void UGameObjectTree::NoteSaveChildrenChanged( UGameObjectContainer* Container )
+{
+	if ( Container == this )
+	{
+		bSaveChildrenDirty = SaveBaseID.IsValid();
+	}
+	else
+	{
+		NoteSaveDirty( Container );
+	}
+}
+
+void UGameObjectTree::ResetSaveDirtyState( const FGuid& BaseID )
+{
+	for ( UGameObject* Object : SaveDirtyObjects )
+	{
+		if ( Object )
+		{
+			Object->bSaveDirty = false;
+		}
+	}
+	SaveDirtyObjects.Reset();
+	SaveRemovedNames.Reset();
+	bSaveChildrenDirty = false;
+	SaveBaseID = BaseID;
+}
+
+void UGameObjectTree::GetSaveChildNames( const UGameObjectContainer* Container, TArray<FName>& OutNames )
+{
+	OutNames.Reserve( Container->GetNumChildren() );
+	for ( const FGameObjectSlot& Slot : Container->ChildSlots )
+	{
+		if ( Slot.Object )
+		{
+			OutNames.Add( Slot.Object->GetSaveName() );
+		}
+	}
+}
@@ -28,10 +28,17 @@ UGame* UGameStatics::GetGameSafe()
 void UGameStatics::GetObjectsWithTag( FString InTag, TSubclassOf<UObjectWithTags> Class, TArray<UObjectWithTags*>& OutObjects )
 {
 	OutObjects.Empty();	
+
+	const int32 TagIndex = FGameTagTable::Get().Find( InTag );
+	if ( TagIndex == INDEX_NONE )
+	{
+		return;
+	}
+
 	for ( TObjectIterator<UObjectWithTags> It; It; ++It )
 	{
 		UObjectWithTags* Obj = *It;
-		if ( !Obj->HasAnyFlags(RF_ClassDefaultObject | RF_ArchetypeObject) && Obj->IsA( Class ) && Obj->HasTag(InTag) )
+		if ( !Obj->HasAnyFlags(RF_ClassDefaultObject | RF_ArchetypeObject) && Obj->IsA( Class ) && Obj->HasTag( TagIndex ) )
 		{
 			OutObjects.Add( Obj );
 		}
@@ -42,6 +49,14 @@ void UGameStatics::GetObjectsWithTag( FString InTag, TSubclassOf<UObjectWithTags
 void UGameStatics::GetObjectsWithTags(ETagFilterType FilterType, TArray<FString> InTags, TSubclassOf<UObjectWithTags> Class, TArray<UObjectWithTags*>& OutObjects)
 {
 	OutObjects.Empty();	
+
+	// Build the query once instead of looking up every tag for every object.
+	FGameTagSet QuerySet;
+	if ( FGameTagSet::Find( InTags, QuerySet ) == false && FilterType == ETagFilterType::HasAllTags )
+	{
+		return;
+	}
+
 	for ( TObjectIterator<UObjectWithTags> It; It; ++It )
 	{
 		UObjectWithTags* Obj = *It;
@@ -49,14 +64,14 @@ void UGameStatics::GetObjectsWithTags(ETagFilterType FilterType, TArray<FString>
 		{
 			if ( FilterType == ETagFilterType::HasAnyTags )
 			{
-				if ( Obj->HasAnyTags(InTags) )
+				if ( Obj->HasAnyTags( QuerySet ) )
 				{
 					OutObjects.Add( Obj );
 				}
 			}
 			else
 			{
-				if ( Obj->HasAllTags(InTags) )
+				if ( Obj->HasAllTags( QuerySet ) )
 				{
 					OutObjects.Add( Obj );
 				}
@@ -72,7 +87,8 @@ void UGameStatics::GetActorsWithTag(UObject* WCO, FString InTag, TArray<AActor*>
 	OutActors.Empty();
 
 	UWorld* World = GEngine->GetWorldFromContextObject( WCO, false );
-	if (!World)
+	const int32 TagIndex = FGameTagTable::Get().Find( InTag );
+	if ( !World || TagIndex == INDEX_NONE )
 	{
 		return;
 	}
@@ -82,7 +98,7 @@ void UGameStatics::GetActorsWithTag(UObject* WCO, FString InTag, TArray<AActor*>
 		AActor* Actor = *It;
 		if ( UGameTagsComponent* Comp = Cast<UGameTagsComponent>( Actor->GetComponentByClass( UGameTagsComponent::StaticClass() ) ) )
 		{
-			if ( Comp->GetTags()->HasTag( InTag ) )
+			if ( Comp->GetTags()->HasTag( TagIndex ) )
 			{
 				OutActors.Add( Actor );
 			}
@@ -96,7 +112,9 @@ void UGameStatics::GetActorsWithTags(UObject* WCO, ETagFilterType FilterType, TA
 	OutActors.Empty();
 
 	UWorld* World = GEngine->GetWorldFromContextObject( WCO, false );
-	if (!World)
+	FGameTagSet QuerySet;
+	const bool bFoundAllTags = FGameTagSet::Find( InTags, QuerySet );
+	if ( !World || ( !bFoundAllTags && FilterType == ETagFilterType::HasAllTags ) )
 	{
 		return;
 	}
@@ -106,11 +124,11 @@ void UGameStatics::GetActorsWithTags(UObject* WCO, ETagFilterType FilterType, TA
 		AActor* Actor = *It;
 		if ( UGameTagsComponent* Comp = Cast<UGameTagsComponent>( Actor->GetComponentByClass( UGameTagsComponent::StaticClass() ) ) )
 		{
-			if ( FilterType == ETagFilterType::HasAnyTags && Comp->GetTags()->HasAnyTags( InTags ) )
+			if ( FilterType == ETagFilterType::HasAnyTags && Comp->GetTags()->HasAnyTags( QuerySet ) )
 			{
 				OutActors.Add( Actor );
 			}
-			else if ( FilterType == ETagFilterType::HasAllTags && Comp->GetTags()->HasAllTags( InTags ) )
+			else if ( FilterType == ETagFilterType::HasAllTags && Comp->GetTags()->HasAllTags( QuerySet ) )
 			{
 				OutActors.Add( Actor );
 			}
@@ -0,0 +1,194 @@
+// @Author Fathurahman <ipat.bogor@gmail.com> @ipatizer
+#include "GamePrivatePCH.h"
+#include "Util/GameTagSet.h"
+
+//////////////////////////////////////////////////////////////////////////
+// FGameTagTable
+//////////////////////////////////////////////////////////////////////////
+
+FGameTagTable::FGameTagTable()
+	: NumTags( 0 )
+{
+	FMemory::Memzero( Chunks, sizeof( Chunks ) );
+	for ( int32 Bucket = 0; Bucket < NumBuckets; Bucket++ )
+	{
+		Buckets[Bucket] = INDEX_NONE;
+	}
+}
+
+FGameTagTable::~FGameTagTable()
+{
+	for ( FEntry* Chunk : Chunks )
+	{
+		delete[] Chunk;
+	}
+}
+
+FGameTagTable& FGameTagTable::Get()
+{
+	static FGameTagTable Table;
+	return Table;
+}
+
+int32 FGameTagTable::Intern( const FString& InTag )
+{
+	const int32 FoundIndex = Find( InTag );
+	if ( FoundIndex != INDEX_NONE )
+	{
+		return FoundIndex;
+	}
+
+	FScopeLock Lock( &CriticalSection );
+
+	// Another thread may have interned the tag while this one was waiting.
+	const int32 RecheckedIndex = Find( InTag );
+	if ( RecheckedIndex != INDEX_NONE )
+	{
+		return RecheckedIndex;
+	}
+
+	const int32 Index = NumTags;
+	check( Index < ChunkSize * MaxChunks );
+	if ( Index % ChunkSize == 0 )
+	{
+		Chunks[Index / ChunkSize] = new FEntry[ChunkSize];
+	}
+
+	const uint32 Bucket = GetTypeHash( InTag ) % NumBuckets;
+	FEntry& Entry = Chunks[Index / ChunkSize][Index % ChunkSize];
+	Entry.Tag = InTag;
+	Entry.NextInBucket = Buckets[Bucket];
+
+	// The entry has to be complete before readers can reach it, the exchanges are full barriers.
+	FPlatformAtomics::InterlockedExchange( &Buckets[Bucket], Index );
+	FPlatformAtomics::InterlockedExchange( &NumTags, Index + 1 );
+	return Index;
+}
+
+int32 FGameTagTable::Find( const FString& InTag ) const
+{
+	const uint32 Bucket = GetTypeHash( InTag ) % NumBuckets;
+	for ( int32 Index = Buckets[Bucket]; Index != INDEX_NONE; )
+	{
+		const FEntry& Entry = GetEntry( Index );
+		if ( Entry.Tag == InTag )
+		{
+			return Index;
+		}
+		Index = Entry.NextInBucket;
+	}
+	return INDEX_NONE;
+}
+
+FString FGameTagTable::GetTag( int32 InIndex ) const
+{
+	if ( InIndex < 0 || InIndex >= NumTags )
+	{
+		return FString();
+	}
+
+	// The entry is only read after the count that has published it.
+	FPlatformMisc::MemoryBarrier();
+	return GetEntry( InIndex ).Tag;
+}
+
+int32 FGameTagTable::Num() const
+{
+	return NumTags;
+}
+
+//////////////////////////////////////////////////////////////////////////
+// FGameTagSet
+//////////////////////////////////////////////////////////////////////////
+
+void FGameTagSet::Add( int32 InIndex )
+{
+	check( InIndex >= 0 );
+
+	const int32 WordIndex = InIndex >> 6;
+	if ( WordIndex >= Words.Num() )
+	{
+		Words.AddZeroed( WordIndex + 1 - Words.Num() );
+	}
+	Words[WordIndex] |= 1ULL << ( InIndex & 63 );
+}
+
+void FGameTagSet::Remove( int32 InIndex )
+{
+	const int32 WordIndex = InIndex >> 6;
+	if ( InIndex >= 0 && WordIndex < Words.Num() )
+	{
+		Words[WordIndex] &= ~( 1ULL << ( InIndex & 63 ) );
+	}
+}
+
+bool FGameTagSet::ContainsAny( const FGameTagSet& Other ) const
+{
+	const int32 NumWords = FMath::Min( Words.Num(), Other.Words.Num() );
+	for ( int32 Index = 0; Index < NumWords; Index++ )
+	{
+		if ( ( Words[Index] & Other.Words[Index] ) != 0 )
+		{
+			return true;
+		}
+	}
+	return false;
+}
+
+bool FGameTagSet::ContainsAll( const FGameTagSet& Other ) const
+{
+	for ( int32 Index = 0; Index < Other.Words.Num(); Index++ )
+	{
+		const uint64 Word = Index < Words.Num() ? Words[Index] : 0;
+		if ( ( Word & Other.Words[Index] ) != Other.Words[Index] )
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+bool FGameTagSet::IsEmpty() const
+{
+	for ( uint64 Word : Words )
+	{
+		if ( Word != 0 )
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+FGameTagSet FGameTagSet::Intern( const TArray<FString>& InTags )
+{
+	FGameTagTable& Table = FGameTagTable::Get();
+
+	FGameTagSet Set;
+	for ( const FString& Tag : InTags )
+	{
+		Set.Add( Table.Intern( Tag ) );
+	}
+	return Set;
+}
+
+bool FGameTagSet::Find( const TArray<FString>& InTags, FGameTagSet& OutSet )
+{
+	FGameTagTable& Table = FGameTagTable::Get();
+
+	bool bFoundAll = true;
+	OutSet.Reset();
+	for ( const FString& Tag : InTags )
+	{
+		const int32 Index = Table.Find( Tag );
+		if ( Index == INDEX_NONE )
+		{
+			bFoundAll = false;
+		}
+		else
+		{
+			OutSet.Add( Index );
+		}
+	}
+	return bFoundAll;
+}
@@ -63,8 +63,13 @@ void GetClasses( UClass* ClassToSearch, TArray<UClass*>& OutResult, bool bAllowA
 	}
 }
 
-UGameObject* StaticCreateGameObject( TSubclassOf<UGameObject> Class )
+UGameObject* StaticCreateGameObject( TSubclassOf<UGameObject> Class, UGameObjectTree* PoolTree )
 {
+	if ( PoolTree && *Class && Class->GetDefaultObject<UGameObject>()->bPoolable )
+	{
+		return PoolTree->CreatePooledObject( Class );
+	}
+
 	UObject* Outer = (UObject*) GetTransientPackage();
 	UGameObject* GameObject = NewObject<UGameObject>( Outer, Class );
 	return GameObject;
@@ -4,31 +4,20 @@
 
 bool UObjectWithTags::HasTag(FString Tag) const
 {
-	return Tags.Contains(Tag);
+	return TagSet.Contains( FGameTagTable::Get().Find( Tag ) );
 }
 
 bool UObjectWithTags::HasAnyTags(const TArray<FString>& InTags) const
 {
-	for (const FString& Tag : InTags)
-	{
-		if (Tags.Contains(Tag))
-		{
-			return true;
-		}
-	}
-	return false;
+	FGameTagSet QuerySet;
+	FGameTagSet::Find( InTags, QuerySet );
+	return TagSet.ContainsAny( QuerySet );
 }
 
 bool UObjectWithTags::HasAllTags(const TArray<FString>& InTags) const
 {
-	for (const FString& Tag : InTags)
-	{
-		if (Tags.Contains(Tag) == false)
-		{
-			return false;
-		}
-	}
-	return true;
+	FGameTagSet QuerySet;
+	return FGameTagSet::Find( InTags, QuerySet ) && TagSet.ContainsAll( QuerySet );
 }
 
 void UObjectWithTags::AddTag(const FString& InTag)
@@ -36,11 +25,58 @@ void UObjectWithTags::AddTag(const FString& InTag)
 	if ( Tags.Contains(InTag) == false )
 	{
 		Tags.Add( InTag );
+		TagSet.Add( FGameTagTable::Get().Intern( InTag ) );
 	}
 }
 
 void UObjectWithTags::RemoveTag(const FString& InTag)
 {
-	Tags.Remove( InTag );
+	if ( Tags.Remove( InTag ) > 0 )
+	{
+		TagSet.Remove( FGameTagTable::Get().Find( InTag ) );
+	}
+}
+
+SIZE_T UObjectWithTags::GetTagsAllocatedSize() const
+{
+	SIZE_T Size = Tags.GetAllocatedSize() + TagSet.GetAllocatedSize();
+	for ( const FString& Tag : Tags )
+	{
+		Size += Tag.GetAllocatedSize();
+	}
+	return Size;
+}
+
+SIZE_T UObjectWithTags::GetResourceSize( EResourceSizeMode::Type Mode )
+{
+	// Tags is a property so it is already counted by memory counting archives, TagSet is not.
+	return Super::GetResourceSize( Mode ) + TagSet.GetAllocatedSize();
 }
 
+void UObjectWithTags::PostInitProperties()
+{
+	Super::PostInitProperties();
+	RebuildTagSet();
+}
+
+void UObjectWithTags::Serialize( FArchive& Ar )
+{
+	Super::Serialize( Ar );
+	if ( Ar.IsLoading() )
+	{
+		RebuildTagSet();
+	}
+}
+
+#if WITH_EDITOR
+void UObjectWithTags::PostEditChangeProperty( FPropertyChangedEvent& PropertyChangedEvent )
+{
+	Super::PostEditChangeProperty( PropertyChangedEvent );
+	RebuildTagSet();
+}
+#endif
+
+void UObjectWithTags::RebuildTagSet()
+{
+	TagSet = FGameTagSet::Intern( Tags );
+}
@@ -0,0 +1,600 @@
+// @Author Fathurahman <ipat.bogor@gmail.com> @ipatizer
+#include "GamePrivatePCH.h"
+#include "Util/PackedTreeRecord.h"
+#include "Object/GameObject.h"
+#include "GameTypes.h"
+#include "Serialization/BufferReader.h"
+
+const int64 FPackedTreeRecordHeader::PackedSize = 2 * sizeof(int32) + 3 * sizeof(int32) + 7 * sizeof(int64);
+
+const int64 FPackedObjectEntry::PackedSize = 4 * sizeof(int32) + 2 * sizeof(int64);
+
+FArchive& operator<<( FArchive& Ar, FPackedTreeRecordHeader& Header )
+{
+	Ar << Header.Magic << Header.Version;
+	Ar << Header.NumStrings << Header.NumClasses << Header.NumObjects;
+	Ar << Header.StringsOffset << Header.ClassesOffset << Header.ObjectsOffset << Header.PayloadOffset << Header.PayloadSize;
+	Ar << Header.TreePayloadOffset << Header.TreePayloadSize;
+	return Ar;
+}
+
+FArchive& operator<<( FArchive& Ar, FPackedObjectEntry& Entry )
+{
+	Ar << Entry.ClassIndex << Entry.NameIndex << Entry.IDIndex << Entry.ParentIndex;
+	Ar << Entry.PayloadOffset << Entry.PayloadSize;
+	return Ar;
+}
+
+/** Whether a range lies within a block of a size. */
+static FORCEINLINE bool IsValidRange( int64 Offset, int64 Size, int64 BlockSize )
+{
+	return Offset >= 0 && Size >= 0 && Offset <= BlockSize && Size <= BlockSize - Offset;
+}
+
+//////////////////////////////////////////////////////////////////////////
+// FPackedTreeRecordWriter
+//////////////////////////////////////////////////////////////////////////
+
+FPackedTreeRecordWriter::FPackedTreeRecordWriter()
+	: TreePayloadOffset( 0 )
+	, TreePayloadSize( 0 )
+{
+}
+
+int32 FPackedTreeRecordWriter::AddString( const FString& String )
+{
+	const int32* pIndex = StringIndices.Find( String );
+	if ( pIndex )
+	{
+		return *pIndex;
+	}
+	const int32 Index = Strings.Add( String );
+	StringIndices.Add( String, Index );
+	return Index;
+}
+
+int32 FPackedTreeRecordWriter::AddName( const FName& Name )
+{
+	const int32* pIndex = NameIndices.Find( Name );
+	if ( pIndex )
+	{
+		return *pIndex;
+	}
+	const int32 Index = AddString( Name.ToString() );
+	NameIndices.Add( Name, Index );
+	return Index;
+}
+
+int32 FPackedTreeRecordWriter::AddClass( UClass* Class )
+{
+	const int32* pIndex = ClassIndices.Find( Class );
+	if ( pIndex )
+	{
+		return *pIndex;
+	}
+
+	// Classes that save more than their SaveGame properties in Serialize opt out of the layout.
+	const UGameObject* DefaultObject = Cast<UGameObject>( Class->GetDefaultObject() );
+	const FSaveGameLayout* Layout = ( DefaultObject && DefaultObject->bUseSaveGameLayout ) ? &FSaveGameLayout::Get( Class ) : nullptr;
+
+	const int32 Index = AddClassPath( Class->GetPathName(), Layout ? &Layout->GetDesc() : nullptr );
+	ClassSaveLayouts[Index] = Layout;
+	ClassIndices.Add( Class, Index );
+	return Index;
+}
+
+int32 FPackedTreeRecordWriter::AddClassPath( const FString& ClassPath, const FSaveGameLayoutDesc* Layout )
+{
+	const int32 StringIndex = AddString( ClassPath );
+	const uint64 Key = ( (uint64) StringIndex << 32 ) | ( Layout ? Layout->Hash : 0 );
+	const int32* pIndex = ClassIndicesByPath.Find( Key );
+	if ( pIndex )
+	{
+		return *pIndex;
+	}
+	const int32 Index = Classes.Add( StringIndex );
+	ClassLayouts.Add( Layout ? *Layout : FSaveGameLayoutDesc() );
+	ClassSaveLayouts.Add( nullptr );
+	ClassIndicesByPath.Add( Key, Index );
+	return Index;
+}
+
+int32 FPackedTreeRecordWriter::AddObject( UGameObject* Object, int32 ParentIndex )
+{
+	const int32 Index = Entries.AddDefaulted();
+	SetObject( Index, Object, ParentIndex );
+	return Index;
+}
+
+void FPackedTreeRecordWriter::SetNumObjects( int32 NumObjects )
+{
+	Entries.SetNum( NumObjects );
+}
+
+void FPackedTreeRecordWriter::SetObject( int32 Index, UGameObject* Object, int32 ParentIndex )
+{
+	check( ParentIndex < Index );
+
+	FPackedObjectEntry& Entry = Entries[Index];
+	Entry.ClassIndex = AddClass( Object->GetClass() );
+	Entry.NameIndex = AddName( Object->GetSaveName() );
+	Entry.IDIndex = Object->GetIDName().IsNone() ? INDEX_NONE : AddName( Object->GetIDName() );
+	Entry.ParentIndex = ParentIndex;
+	Entry.PayloadOffset = Payload.Num();
+
+	FMemoryWriter Writer( Payload, false, true );
+	FSaveGameArchive Ar( Writer );
+	if ( const FSaveGameLayout* Layout = ClassSaveLayouts[Entry.ClassIndex] )
+	{
+		Layout->Save( Object, Ar );
+	}
+	else
+	{
+		Object->Serialize( Ar );
+	}
+
+	Entry.PayloadSize = Payload.Num() - Entry.PayloadOffset;
+}
+
+int32 FPackedTreeRecordWriter::GetNumUnsetObjects() const
+{
+	int32 NumUnset = 0;
+	for ( const FPackedObjectEntry& Entry : Entries )
+	{
+		NumUnset += Entry.ClassIndex == INDEX_NONE ? 1 : 0;
+	}
+	return NumUnset;
+}
+
+uint32 FPackedTreeRecordWriter::GetObjectDataCrc( int32 Index ) const
+{
+	const FPackedObjectEntry& Entry = Entries[Index];
+	return FCrc::MemCrc32( Payload.GetData() + Entry.PayloadOffset, (int32) Entry.PayloadSize );
+}
+
+int32 FPackedTreeRecordWriter::AddPackedObject( const FString& ClassPath, const FSaveGameLayoutDesc* Layout, const FName& Name, const FName& ID, int32 ParentIndex, const uint8* ObjectData, int64 ObjectDataSize )
+{
+	check( ParentIndex < Entries.Num() );
+
+	FPackedObjectEntry Entry;
+	Entry.ClassIndex = AddClassPath( ClassPath, Layout );
+	Entry.NameIndex = AddName( Name );
+	Entry.IDIndex = ID.IsNone() ? INDEX_NONE : AddName( ID );
+	Entry.ParentIndex = ParentIndex;
+	Entry.PayloadOffset = Payload.Num();
+	Entry.PayloadSize = ObjectDataSize;
+	Payload.Append( ObjectData, ObjectDataSize );
+	return Entries.Add( Entry );
+}
+
+void FPackedTreeRecordWriter::SetTreeData( const uint8* TreeData, int64 TreeDataSize )
+{
+	TreePayloadOffset = Payload.Num();
+	TreePayloadSize = TreeDataSize;
+	Payload.Append( TreeData, TreeDataSize );
+}
+
+void FPackedTreeRecordWriter::SetTreeData( UObject* Tree )
+{
+	TreePayloadOffset = Payload.Num();
+
+	FMemoryWriter Writer( Payload, false, true );
+	FSaveGameArchive Ar( Writer );
+	Tree->Serialize( Ar );
+
+	TreePayloadSize = Payload.Num() - TreePayloadOffset;
+}
+
+void FPackedTreeRecordWriter::Finish( TArray<uint8>& OutBytes )
+{
+	OutBytes.Reset();
+
+	// The names and types of the layouts are in the string table, which is written before the classes.
+	TArray<int32> LayoutStringIndices;
+	for ( const FSaveGameLayoutDesc& Layout : ClassLayouts )
+	{
+		for ( const FSaveGamePropertyDesc& Property : Layout.Properties )
+		{
+			LayoutStringIndices.Add( AddName( Property.Name ) );
+			LayoutStringIndices.Add( AddName( Property.Type ) );
+		}
+	}
+
+	FMemoryWriter Writer( OutBytes );
+	FPackedTreeRecordHeader Header;
+	Writer << Header;
+
+	// Strings are written as UTF-8 so that the common ASCII names take a byte per character.
+	Header.NumStrings = Strings.Num();
+	Header.StringsOffset = Writer.Tell();
+	for ( const FString& String : Strings )
+	{
+		FTCHARToUTF8 UTF8String( *String );
+		int32 Length = UTF8String.Length();
+		Writer << Length;
+		Writer.Serialize( (void*) UTF8String.Get(), Length );
+	}
+
+	Header.NumClasses = Classes.Num();
+	Header.ClassesOffset = Writer.Tell();
+	int32 NextLayoutString = 0;
+	for ( int32 Index = 0; Index < Classes.Num(); Index++ )
+	{
+		FSaveGameLayoutDesc& Layout = ClassLayouts[Index];
+		int32 NumProperties = Layout.Properties.Num();
+		Writer << Classes[Index] << Layout.Hash << NumProperties;
+
+		for ( FSaveGamePropertyDesc& Property : Layout.Properties )
+		{
+			int32 NameIndex = LayoutStringIndices[NextLayoutString++];
+			int32 TypeIndex = LayoutStringIndices[NextLayoutString++];
+			Writer << NameIndex << TypeIndex << Property.ArrayDim << Property.Size;
+		}
+	}
+
+	Header.NumObjects = Entries.Num();
+	Header.ObjectsOffset = Writer.Tell();
+	for ( FPackedObjectEntry& Entry : Entries )
+	{
+		check( Entry.ClassIndex != INDEX_NONE );
+		Writer << Entry;
+	}
+
+	Header.PayloadOffset = Writer.Tell();
+	Header.PayloadSize = Payload.Num();
+	Header.TreePayloadOffset = TreePayloadOffset;
+	Header.TreePayloadSize = TreePayloadSize;
+	Writer.Serialize( Payload.GetData(), Payload.Num() );
+
+	Writer.Seek( 0 );
+	Writer << Header;
+}
+
+/** An object while deltas are merged, its data points either into the base or into a delta. */
+struct FPackedMergeNode
+{
+	FString ClassPath;
+
+	/** The layout the object has been serialized with, null for the tagged path. */
+	const FSaveGameLayoutDesc* Layout = nullptr;
+
+	FName ID;
+	const uint8* ObjectData = nullptr;
+	int64 ObjectDataSize = 0;
+	TArray<FName> ChildNames;
+	bool bIsAdded = false;
+};
+
+/** Add a merged object and its descendants to a writer, in depth first order. */
+static void AddMergeNode_Recursive( FPackedTreeRecordWriter& Writer, TMap<FName, FPackedMergeNode>& Nodes, const FName& Name, int32 ParentIndex )
+{
+	FPackedMergeNode* Node = Nodes.Find( Name );
+	if ( !Node || Node->bIsAdded )
+	{
+		return;
+	}
+	Node->bIsAdded = true;
+
+	const int32 Index = Writer.AddPackedObject( Node->ClassPath, Node->Layout, Name, Node->ID, ParentIndex, Node->ObjectData, Node->ObjectDataSize );
+
+	// Nodes are not added to the map while it is being walked, so the node stays where it is.
+	for ( const FName& ChildName : Node->ChildNames )
+	{
+		AddMergeNode_Recursive( Writer, Nodes, ChildName, Index );
+	}
+}
+
+bool FPackedTreeRecordWriter::MergeDeltas( const TArray<uint8>& InBase, const TArray<FGameObjectTreeDeltaRecord>& InDeltas, TArray<uint8>& OutMerged )
+{
+	FPackedTreeRecordReader Reader;
+	if ( !Reader.Open( InBase.GetData(), InBase.Num(), false ) )
+	{
+		return false;
+	}
+
+	const int32 NumObjects = Reader.GetNumObjects();
+	TMap<FName, FPackedMergeNode> Nodes;
+	Nodes.Reserve( NumObjects );
+	TArray<FName> EntryNames;
+	EntryNames.Reserve( NumObjects );
+	TArray<FName> TreeChildNames;
+
+	for ( int32 Index = 0; Index < NumObjects; Index++ )
+	{
+		const FPackedObjectEntry& Entry = Reader.GetEntry( Index );
+		const FName Name = Reader.GetName( Entry );
+		EntryNames.Add( Name );
+
+		FPackedMergeNode& Node = Nodes.Add( Name );
+		Node.ClassPath = Reader.GetClassPath( Entry );
+		Node.Layout = &Reader.GetClassLayout( Entry );
+		Node.ID = Reader.GetID( Entry );
+		Node.ObjectData = Reader.GetObjectData( Entry );
+		Node.ObjectDataSize = Entry.PayloadSize;
+
+		if ( Entry.ParentIndex == INDEX_NONE )
+		{
+			TreeChildNames.Add( Name );
+		}
+		else if ( FPackedMergeNode* ParentNode = Nodes.Find( EntryNames[Entry.ParentIndex] ) )
+		{
+			ParentNode->ChildNames.Add( Name );
+		}
+	}
+
+	const uint8* TreeData = Reader.GetTreeData();
+	int64 TreeDataSize = Reader.GetHeader().TreePayloadSize;
+
+	for ( const FGameObjectTreeDeltaRecord& Delta : InDeltas )
+	{
+		for ( const FName& Name : Delta.RemovedNames )
+		{
+			Nodes.Remove( Name );
+		}
+
+		for ( const FGameObjectDeltaRecord& ObjectRecord : Delta.ObjectRecords )
+		{
+			FPackedMergeNode& Node = Nodes.FindOrAdd( ObjectRecord.Name );
+			Node.ClassPath = ObjectRecord.ClassPath;
+			Node.Layout = nullptr;
+			Node.ID = ObjectRecord.ID;
+			Node.ObjectData = ObjectRecord.ByteData.GetData();
+			Node.ObjectDataSize = ObjectRecord.ByteData.Num();
+			if ( ObjectRecord.bHasChildren )
+			{
+				Node.ChildNames = ObjectRecord.ChildNames;
+			}
+		}
+
+		TreeData = Delta.ByteData.GetData();
+		TreeDataSize = Delta.ByteData.Num();
+		if ( Delta.bHasChildren )
+		{
+			TreeChildNames = Delta.ChildNames;
+		}
+	}
+
+	FPackedTreeRecordWriter Writer;
+	for ( const FName& Name : TreeChildNames )
+	{
+		AddMergeNode_Recursive( Writer, Nodes, Name, INDEX_NONE );
+	}
+	Writer.SetTreeData( TreeData, TreeDataSize );
+	Writer.Finish( OutMerged );
+	return true;
+}
+
+//////////////////////////////////////////////////////////////////////////
+// FPackedTreeRecordReader
+//////////////////////////////////////////////////////////////////////////
+
+FPackedTreeRecordReader::FPackedTreeRecordReader()
+	: Data( nullptr )
+	, Size( 0 )
+{
+}
+
+bool FPackedTreeRecordReader::Validate( const uint8* InData, int64 InSize )
+{
+	FPackedTreeRecordReader Reader;
+	return Reader.ReadTables( InData, InSize );
+}
+
+bool FPackedTreeRecordReader::Open( const uint8* InData, int64 InSize, bool bResolveClasses )
+{
+	if ( !ReadTables( InData, InSize ) )
+	{
+		return false;
+	}
+
+	if ( !bResolveClasses )
+	{
+		return true;
+	}
+
+	Classes.Reset( ClassPathIndices.Num() );
+	for ( int32 ClassPathIndex : ClassPathIndices )
+	{
+		UClass* Class = LoadObject<UClass>( nullptr, *Strings[ClassPathIndex] );
+		Classes.Add( Class );
+	}
+	return true;
+}
+
+bool FPackedTreeRecordReader::ReadTables( const uint8* InData, int64 InSize )
+{
+	Data = nullptr;
+	Size = 0;
+	Strings.Reset();
+	ClassPathIndices.Reset();
+	ClassLayouts.Reset();
+	Classes.Reset();
+	Entries.Reset();
+	Blocks.Reset();
+	MatchedProperties.Reset();
+
+	if ( !InData || InSize < FPackedTreeRecordHeader::PackedSize )
+	{
+		return false;
+	}
+
+	FBufferReader Reader( (void*) InData, InSize, false );
+	Reader << Header;
+
+	if ( Header.Magic != FPackedTreeRecordHeader::PackedMagic || Header.Version < EPackedTreeRecordVersion::Initial || Header.Version > EPackedTreeRecordVersion::Latest )
+	{
+		PrintLogError( "Packed tree record has an unknown magic or version (%d)", Header.Version );
+		return false;
+	}
+
+	// Before layouts every class is a single string index, with layouts it is at least the index, the hash and the number of properties.
+	const bool bHasLayouts = Header.Version >= EPackedTreeRecordVersion::SaveGameLayouts;
+	const int64 MinClassSize = ( bHasLayouts ? 3 : 1 ) * sizeof(int32);
+
+	// The sections follow one another, so every section ends where the next one starts.
+	if ( Header.NumStrings < 0 || Header.NumClasses < 0 || Header.NumObjects < 0
+		|| Header.StringsOffset != FPackedTreeRecordHeader::PackedSize || Header.NumStrings * (int64) sizeof(int32) > Header.ClassesOffset - Header.StringsOffset
+		|| !IsValidRange( Header.ClassesOffset, Header.NumClasses * MinClassSize, InSize ) || Header.ClassesOffset < Header.StringsOffset
+		|| Header.ObjectsOffset < Header.ClassesOffset + Header.NumClasses * MinClassSize
+		|| ( !bHasLayouts && Header.ObjectsOffset != Header.ClassesOffset + Header.NumClasses * MinClassSize )
+		|| !IsValidRange( Header.ObjectsOffset, Header.NumObjects * FPackedObjectEntry::PackedSize, InSize )
+		|| Header.PayloadOffset != Header.ObjectsOffset + Header.NumObjects * FPackedObjectEntry::PackedSize
+		|| !IsValidRange( Header.PayloadOffset, Header.PayloadSize, InSize )
+		|| !IsValidRange( Header.TreePayloadOffset, Header.TreePayloadSize, Header.PayloadSize ) )
+	{
+		PrintLogError( "Packed tree record has corrupt sections" );
+		return false;
+	}
+
+	Strings.Reserve( Header.NumStrings );
+	TArray<ANSICHAR> UTF8String;
+	for ( int32 Index = 0; Index < Header.NumStrings; Index++ )
+	{
+		int32 Length = 0;
+		Reader << Length;
+		if ( Reader.IsError() || !IsValidRange( Reader.Tell(), Length, Header.ClassesOffset ) )
+		{
+			PrintLogError( "Packed tree record has a corrupt string table" );
+			return false;
+		}
+		UTF8String.SetNumUninitialized( Length + 1, false );
+		Reader.Serialize( UTF8String.GetData(), Length );
+		UTF8String[Length] = 0;
+		Strings.Add( UTF8_TO_TCHAR( UTF8String.GetData() ) );
+	}
+
+	if ( Reader.Tell() != Header.ClassesOffset )
+	{
+		PrintLogError( "Packed tree record has a corrupt string table" );
+		return false;
+	}
+
+	ClassPathIndices.SetNumUninitialized( Header.NumClasses );
+	ClassLayouts.SetNum( Header.NumClasses );
+	for ( int32 Index = 0; Index < Header.NumClasses; Index++ )
+	{
+		int32& ClassPathIndex = ClassPathIndices[Index];
+		Reader << ClassPathIndex;
+		if ( !Strings.IsValidIndex( ClassPathIndex ) )
+		{
+			PrintLogError( "Packed tree record has a corrupt class table" );
+			return false;
+		}
+
+		if ( !bHasLayouts )
+		{
+			continue;
+		}
+
+		FSaveGameLayoutDesc& Layout = ClassLayouts[Index];
+		int32 NumProperties = 0;
+		Reader << Layout.Hash << NumProperties;
+		if ( Reader.IsError() || NumProperties < 0 || NumProperties * 4 * (int64) sizeof(int32) > Header.ObjectsOffset - Reader.Tell() )
+		{
+			PrintLogError( "Packed tree record has a corrupt class table" );
+			return false;
+		}
+
+		Layout.Properties.SetNum( NumProperties );
+		for ( FSaveGamePropertyDesc& Property : Layout.Properties )
+		{
+			int32 NameIndex = INDEX_NONE;
+			int32 TypeIndex = INDEX_NONE;
+			Reader << NameIndex << TypeIndex << Property.ArrayDim << Property.Size;
+			if ( !Strings.IsValidIndex( NameIndex ) || !Strings.IsValidIndex( TypeIndex ) || Property.ArrayDim <= 0 || Property.Size < 0 )
+			{
+				PrintLogError( "Packed tree record has a corrupt class layout" );
+				return false;
+			}
+			Property.Name = FName( *Strings[NameIndex] );
+			Property.Type = FName( *Strings[TypeIndex] );
+		}
+	}
+
+	if ( Reader.Tell() != Header.ObjectsOffset )
+	{
+		PrintLogError( "Packed tree record has a corrupt class table" );
+		return false;
+	}
+
+	Entries.SetNum( Header.NumObjects );
+	for ( int32 Index = 0; Index < Header.NumObjects; Index++ )
+	{
+		FPackedObjectEntry& Entry = Entries[Index];
+		Reader << Entry;
+		if ( !ClassPathIndices.IsValidIndex( Entry.ClassIndex ) || !Strings.IsValidIndex( Entry.NameIndex )
+			|| ( Entry.IDIndex != INDEX_NONE && !Strings.IsValidIndex( Entry.IDIndex ) )
+			|| Entry.ParentIndex < INDEX_NONE || Entry.ParentIndex >= Index
+			|| !IsValidRange( Entry.PayloadOffset, Entry.PayloadSize, Header.PayloadSize ) )
+		{
+			PrintLogError( "Packed tree record has a corrupt object entry (%d)", Index );
+			return false;
+		}
+
+		// Every top level object starts a block, the other objects must be in the block of their parent.
+		if ( Entry.ParentIndex == INDEX_NONE )
+		{
+			FPackedSubtreeBlock& Block = Blocks[ Blocks.AddDefaulted() ];
+			Block.FirstEntry = Index;
+		}
+		else if ( Entry.ParentIndex < Blocks.Last().FirstEntry )
+		{
+			PrintLogError( "Packed tree record has an object out of depth first order (%d)", Index );
+			return false;
+		}
+		Blocks.Last().NumEntries++;
+	}
+
+	if ( Reader.IsError() )
+	{
+		return false;
+	}
+
+	Data = InData;
+	Size = InSize;
+	return true;
+}
+
+bool FPackedTreeRecordReader::SerializeObject( const FPackedObjectEntry& Entry, UObject* Object ) const
+{
+	const FSaveGameLayoutDesc& SavedLayout = ClassLayouts[Entry.ClassIndex];
+	if ( SavedLayout.IsTagged() )
+	{
+		return SerializePayload( Entry.PayloadOffset, Entry.PayloadSize, Object );
+	}
+
+	check( Data );
+
+	FBufferReader Reader( (void*) ( Data + Header.PayloadOffset + Entry.PayloadOffset ), Entry.PayloadSize, false );
+	FSaveGameArchive Ar( Reader );
+
+	const FSaveGameLayout& Layout = FSaveGameLayout::Get( Object->GetClass() );
+	if ( Layout.GetHash() == SavedLayout.Hash )
+	{
+		return Layout.Load( Object, Ar );
+	}
+
+	// The class has changed since the record has been saved, its properties are matched once for all its objects.
+	TArray<UProperty*>* Properties = MatchedProperties.Find( Entry.ClassIndex );
+	if ( !Properties )
+	{
+		Properties = &MatchedProperties.Add( Entry.ClassIndex );
+		Layout.MatchProperties( SavedLayout, *Properties );
+	}
+	return FSaveGameLayout::LoadMatched( Object, Ar, SavedLayout, *Properties );
+}
+
+bool FPackedTreeRecordReader::SerializeTree( UObject* Tree ) const
+{
+	return SerializePayload( Header.TreePayloadOffset, Header.TreePayloadSize, Tree );
+}
+
+bool FPackedTreeRecordReader::SerializePayload( int64 Offset, int64 PayloadSize, UObject* Object ) const
+{
+	check( Data );
+
+	FBufferReader Reader( (void*) ( Data + Header.PayloadOffset + Offset ), PayloadSize, false );
+	FSaveGameArchive Ar( Reader );
+	Object->Serialize( Ar );
+	return !Ar.IsError();
+}
@@ -0,0 +1,280 @@
+// @Author Fathurahman <ipat.bogor@gmail.com> @ipatizer
+#include "GamePrivatePCH.h"
+#include "Util/SaveGameLayout.h"
+
+static TMap<UClass*, TSharedPtr<FSaveGameLayout>> SaveGameLayouts;
+
+/** Whether the value of a property can be copied as is. */
+static bool IsPlainOldData( const UProperty* Property )
+{
+	if ( Property->IsA<UNumericProperty>() )
+	{
+		return true;
+	}
+	if ( const UBoolProperty* BoolProperty = Cast<UBoolProperty>( Property ) )
+	{
+		// Bitfields share their byte with other properties.
+		return BoolProperty->IsNativeBool();
+	}
+	if ( const UStructProperty* StructProperty = Cast<UStructProperty>( Property ) )
+	{
+		return ( StructProperty->Struct->StructFlags & STRUCT_IsPlainOldData ) != 0;
+	}
+	return false;
+}
+
+static FString GetPropertyType( const UProperty* Property );
+
+/**
+* Hash of the names, types, offsets and sizes of the members of a struct. A plain old data struct is copied as is, 
+* so a struct of the same name and size whose members have moved must not be taken for the one the data has been saved with.
+*/
+static uint32 GetStructLayoutHash( const UScriptStruct* Struct )
+{
+	uint32 Hash = 0;
+	for ( TFieldIterator<UProperty> It( Struct ); It; ++It )
+	{
+		const int32 Offset = It->GetOffset_ForInternal();
+		const int32 Size = It->GetSize();
+		Hash = FCrc::StrCrc32( *It->GetName(), Hash );
+		Hash = FCrc::StrCrc32( *GetPropertyType( *It ), Hash );
+		Hash = FCrc::MemCrc32( &Offset, sizeof(int32), Hash );
+		Hash = FCrc::MemCrc32( &Size, sizeof(int32), Hash );
+	}
+	return Hash;
+}
+
+/** The type of a property, plain old data structs also have the hash of their layout, e.g. StructProperty<Vector:1A2B3C4D>. */
+static FString GetPropertyType( const UProperty* Property )
+{
+	FString Type = Property->GetClass()->GetName();
+	if ( const UStructProperty* StructProperty = Cast<UStructProperty>( Property ) )
+	{
+		if ( IsPlainOldData( StructProperty ) )
+		{
+			Type += FString::Printf( TEXT("<%s:%08X>"), *StructProperty->Struct->GetName(), GetStructLayoutHash( StructProperty->Struct ) );
+		}
+		else
+		{
+			Type += FString::Printf( TEXT("<%s>"), *StructProperty->Struct->GetName() );
+		}
+	}
+	else if ( const UArrayProperty* ArrayProperty = Cast<UArrayProperty>( Property ) )
+	{
+		Type += FString::Printf( TEXT("<%s>"), *GetPropertyType( ArrayProperty->Inner ) );
+	}
+	return Type;
+}
+
+/** Serialize a property that can not be copied as is behind its size, so it can be skipped when it is loaded. */
+static void SaveProperty( UProperty* Property, uint8* Data, FArchive& Ar )
+{
+	const int64 SizeOffset = Ar.Tell();
+	int32 Size = 0;
+	Ar << Size;
+
+	const int64 Start = Ar.Tell();
+	for ( int32 Index = 0; Index < Property->ArrayDim; Index++ )
+	{
+		Property->SerializeItem( Ar, Property->ContainerPtrToValuePtr<void>( Data, Index ) );
+	}
+	const int64 End = Ar.Tell();
+
+	Size = (int32) ( End - Start );
+	Ar.Seek( SizeOffset );
+	Ar << Size;
+	Ar.Seek( End );
+}
+
+/** Load a property saved by SaveProperty, or skip it if the property is null. */
+static bool LoadProperty( UProperty* Property, uint8* Data, FArchive& Ar )
+{
+	int32 Size = 0;
+	Ar << Size;
+
+	const int64 Start = Ar.Tell();
+	if ( Ar.IsError() || Size < 0 || Size > Ar.TotalSize() - Start )
+	{
+		return false;
+	}
+
+	if ( Property )
+	{
+		for ( int32 Index = 0; Index < Property->ArrayDim; Index++ )
+		{
+			Property->SerializeItem( Ar, Property->ContainerPtrToValuePtr<void>( Data, Index ) );
+		}
+	}
+	Ar.Seek( Start + Size );
+	return !Ar.IsError();
+}
+
+//////////////////////////////////////////////////////////////////////////
+// FSaveGameLayout
+//////////////////////////////////////////////////////////////////////////
+
+const FSaveGameLayout& FSaveGameLayout::Get( UClass* Class )
+{
+	check( IsInGameThread() && Class );
+
+	TSharedPtr<FSaveGameLayout>& Layout = SaveGameLayouts.FindOrAdd( Class );
+	if ( !Layout.IsValid() || !Layout->IsUpToDate( Class ) )
+	{
+		Layout = MakeShareable( new FSaveGameLayout( Class ) );
+	}
+	return *Layout;
+}
+
+void FSaveGameLayout::Reset()
+{
+	SaveGameLayouts.Empty();
+}
+
+FSaveGameLayout::FSaveGameLayout( UClass* InClass )
+	: Class( InClass )
+	, PropertyLink( InClass->PropertyLink )
+	, PropertiesSize( InClass->PropertiesSize )
+{
+	for ( TFieldIterator<UProperty> It( InClass ); It; ++It )
+	{
+		if ( It->HasAnyPropertyFlags( CPF_SaveGame ) && !It->HasAnyPropertyFlags( CPF_Deprecated ) )
+		{
+			Properties.Add( *It );
+		}
+	}
+
+	// In memory order, so that the plain old data properties next to each other become a single block.
+	Properties.Sort( []( const UProperty& A, const UProperty& B )
+	{
+		return A.GetOffset_ForInternal() < B.GetOffset_ForInternal();
+	} );
+
+	uint32 Hash = 0;
+	Desc.Properties.Reserve( Properties.Num() );
+	for ( UProperty* Property : Properties )
+	{
+		const bool bIsPlainOldData = IsPlainOldData( Property );
+
+		FSaveGamePropertyDesc& PropertyDesc = Desc.Properties[ Desc.Properties.AddDefaulted() ];
+		PropertyDesc.Name = Property->GetFName();
+		PropertyDesc.Type = FName( *GetPropertyType( Property ) );
+		PropertyDesc.ArrayDim = Property->ArrayDim;
+		PropertyDesc.Size = bIsPlainOldData ? Property->GetSize() : 0;
+
+		Hash = FCrc::StrCrc32( *PropertyDesc.Name.ToString(), Hash );
+		Hash = FCrc::StrCrc32( *PropertyDesc.Type.ToString(), Hash );
+		Hash = FCrc::MemCrc32( &PropertyDesc.ArrayDim, sizeof(int32), Hash );
+		Hash = FCrc::MemCrc32( &PropertyDesc.Size, sizeof(int32), Hash );
+
+		const int32 Offset = Property->GetOffset_ForInternal();
+		if ( bIsPlainOldData && Steps.Num() > 0 && !Steps.Last().Property && Steps.Last().Offset + Steps.Last().Size == Offset )
+		{
+			Steps.Last().Size += PropertyDesc.Size;
+			continue;
+		}
+
+		FStep Step;
+		Step.Offset = Offset;
+		Step.Size = PropertyDesc.Size;
+		Step.Property = bIsPlainOldData ? nullptr : Property;
+		Steps.Add( Step );
+	}
+
+	// Zero tells the records that the objects are saved through the tagged path.
+	Desc.Hash = ( Hash != 0 ) ? Hash : 1;
+}
+
+bool FSaveGameLayout::IsUpToDate( UClass* InClass ) const
+{
+	return Class.Get() == InClass && PropertyLink == InClass->PropertyLink && PropertiesSize == InClass->PropertiesSize;
+}
+
+void FSaveGameLayout::Save( UObject* Object, FArchive& Ar ) const
+{
+	uint8* Data = (uint8*) Object;
+	for ( const FStep& Step : Steps )
+	{
+		if ( Step.Property )
+		{
+			SaveProperty( Step.Property, Data, Ar );
+		}
+		else
+		{
+			Ar.Serialize( Data + Step.Offset, Step.Size );
+		}
+	}
+}
+
+bool FSaveGameLayout::Load( UObject* Object, FArchive& Ar ) const
+{
+	uint8* Data = (uint8*) Object;
+	for ( const FStep& Step : Steps )
+	{
+		if ( Step.Property )
+		{
+			if ( !LoadProperty( Step.Property, Data, Ar ) )
+			{
+				return false;
+			}
+		}
+		else
+		{
+			Ar.Serialize( Data + Step.Offset, Step.Size );
+		}
+	}
+	return !Ar.IsError();
+}
+
+void FSaveGameLayout::MatchProperties( const FSaveGameLayoutDesc& SavedDesc, TArray<UProperty*>& OutProperties ) const
+{
+	OutProperties.Reset( SavedDesc.Properties.Num() );
+	for ( const FSaveGamePropertyDesc& SavedProperty : SavedDesc.Properties )
+	{
+		UProperty* Match = nullptr;
+		for ( int32 Index = 0; Index < Desc.Properties.Num(); Index++ )
+		{
+			const FSaveGamePropertyDesc& PropertyDesc = Desc.Properties[Index];
+			if ( PropertyDesc.Name == SavedProperty.Name && PropertyDesc.Type == SavedProperty.Type
+				&& PropertyDesc.ArrayDim == SavedProperty.ArrayDim && PropertyDesc.Size == SavedProperty.Size )
+			{
+				Match = Properties[Index];
+				break;
+			}
+		}
+		OutProperties.Add( Match );
+	}
+}
+
+bool FSaveGameLayout::LoadMatched( UObject* Object, FArchive& Ar, const FSaveGameLayoutDesc& SavedDesc, const TArray<UProperty*>& InProperties )
+{
+	check( InProperties.Num() == SavedDesc.Properties.Num() );
+
+	uint8* Data = (uint8*) Object;
+	for ( int32 Index = 0; Index < SavedDesc.Properties.Num(); Index++ )
+	{
+		const int32 Size = SavedDesc.Properties[Index].Size;
+		UProperty* Property = InProperties[Index];
+
+		if ( Size == 0 )
+		{
+			if ( !LoadProperty( Property, Data, Ar ) )
+			{
+				return false;
+			}
+		}
+		else if ( Property )
+		{
+			Ar.Serialize( Property->ContainerPtrToValuePtr<void>( Data ), Size );
+		}
+		else
+		{
+			Ar.Seek( Ar.Tell() + Size );
+		}
+
+		if ( Ar.IsError() || Ar.Tell() > Ar.TotalSize() )
+		{
+			return false;
+		}
+	}
+	return true;
+}
@@ -1,12 +1,51 @@
 // @Author Fathurahman <ipat.bogor@gmail.com> @ipatizer
 #include "GamePrivatePCH.h"
 #include "Components/StateMachineComponent.h"
+#include "Util/BlueprintEventCache.h"
+
+/** Blueprint events of UState, in the order of their names in StateEvents. */
+enum EStateEvent
+{
+	SE_Enter,
+	SE_Exit,
+	SE_Event,
+};
+
+static FBlueprintEventCache StateEvents( {
+	TEXT("ReceiveOnEnter"),
+	TEXT("ReceiveOnExit"),
+	TEXT("ReceiveEvent"),
+} );
 
 UState::UState(const FObjectInitializer& ObjectInitializer)
 	: Super( ObjectInitializer )
 {
 }
 
+void UState::OnEnter()
+{
+	if ( StateEvents.IsImplemented( this, SE_Enter ) )
+	{
+		ReceiveOnEnter();
+	}
+}
+
+void UState::OnExit()
+{
+	if ( StateEvents.IsImplemented( this, SE_Exit ) )
+	{
+		ReceiveOnExit();
+	}
+}
+
+void UState::OnEvent( const FString& EventName, UObject* Object )
+{
+	if ( StateEvents.IsImplemented( this, SE_Event ) )
+	{
+		ReceiveEvent( EventName, Object );
+	}
+}
+
 UStateMachineComponent* UState::GetOwningComponent() const
 {
 	return OwningStateMachine.IsValid() ? OwningStateMachine->OwningComponent.Get() : nullptr;
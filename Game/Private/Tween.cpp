@@ -1,6 +1,7 @@
 // @Author Fathurahman <ipat.bogor@gmail.com> @ipatizer
 #include "GamePrivatePCH.h"
 #include "Util/Tween.h"
+#include "GameStats.h"
 
 //////////////////////////////////////////////////////////////////////////
 // UTween
@@ -416,6 +417,9 @@ bool UTweener::IsTweening() const
 
 void UTweener::Tick(float DeltaSeconds)
 {
+	SCOPE_CYCLE_COUNTER( STAT_GameModules_TweenerTick );
+	INC_DWORD_STAT_BY( STAT_GameModules_TweensActive, TweenObjects.Num() );
+
 	TArray<UTween*> TweenObjectsCopy = TweenObjects;
 	TweenObjects.Empty();
 
@@ -5,6 +5,8 @@
 #include "Object/GameObjectTree.h"
 #include "Game.generated.h"
 
+/** Called when an incremental save of a game is done, with whether it has succeeded and the record it has been saved into. */
+DECLARE_DELEGATE_TwoParams( FOnGameSavedToRecord, bool /*bSuccess*/, FGameRecord& /*Record*/ );
 
 /** UGame
 * A basic game Game class that stores object tree, can do simulation, and can be serialized to save game.
@@ -73,6 +75,22 @@ public:
 	UFUNCTION(BlueprintCallable, Category="Game")
 	bool SaveToRecord( FGameRecord& OutRecord ) const;
 
+	/**
+	* Save only what has changed since the previous save into a record, @see UGameObjectTree::SaveDeltaToRecord
+	* @param	InOutRecord		The record of the previous save, or of the load, of this game.
+	* @return false if there's an error while saving the Game.
+	*/
+	bool SaveDeltaToRecord( FGameRecord& InOutRecord );
+
+	/**
+	* Begin saving this game to a record over several ticks, @see UGameObjectTree::BeginIncrementalSave
+	* The data of the game itself is taken right away, together with the snapshot of the object tree.
+	* @param	BudgetSeconds	Time to spend capturing objects per tick.
+	* @param	OnSaved			Called once the record is complete, or the save has been cancelled.
+	* @return false if another save is already in progress.
+	*/
+	bool BeginIncrementalSave( float BudgetSeconds, const FOnGameSavedToRecord& OnSaved );
+
 	/** Get the object tree root. */
 	UFUNCTION(BlueprintPure, Category="GameObject")
 	UGameObjectTree* GetObjectTree() const;	
@@ -258,6 +276,13 @@ private:
 	/** Whether this game has been initialized and ready to be used. */
 	bool bIsInitialized;
 
+	/** The record of the incremental save in progress, waiting for the object tree to be captured. */
+	FGameRecord PendingSaveRecord;
+
+	FOnGameSavedToRecord PendingSaveCompleted;
+
+	void OnObjectTreeSaved( bool bSuccess, FGameObjectTreeRecord& TreeRecord );
+
 	/** Initialize this game object. */
 	void Init();
 
@@ -37,6 +37,10 @@ UCLASS(Blueprintable)
 class GAME_API UGameManager : public UGameInstance
 {
     GENERATED_BODY()
+
+	DECLARE_DYNAMIC_DELEGATE_OneParam(FOnGameSaved, bool, bSuccess);
+	DECLARE_DYNAMIC_DELEGATE_OneParam(FOnGameLoaded, bool, bSuccess);
+
 public:
 
 	static UGameManager* Get();
@@ -58,14 +62,77 @@ public:
 	UFUNCTION(BlueprintCallable, Category="GameManager")
 	void StopGame();
 
-	/** Load an existing game. */
+	/**
+	* Load an existing game, from a slot saved by the game manager or by UGameplayStatics::SaveGameToSlot.
+	* Waits for the async reads and writes of the slot that are still pending.
+	*/
 	UFUNCTION(BlueprintCallable, Category="GameManager")
 	bool LoadGame( const FString& SlotName, int32 UserIndex = 0 );
 
-	/** Save an existing game. */
+	/**
+	* Save an existing game, after the async writes of the slot that are still pending.
+	* The slot is written in the format of the game manager, which has the versions it has been written with and may be compressed,
+	* it has to be loaded with LoadGame or LoadGameAsync, UGameplayStatics::LoadGameFromSlot can not read it.
+	*/
 	UFUNCTION(BlueprintCallable, Category="GameManager")
 	bool SaveGame( const FString& SlotName, int32 UserIndex = 0 );
 
+	/**
+	* Load a game without blocking the game thread on the storage.
+	* The save slot is read and decoded on a worker thread, only the objects are created on the game thread.
+	* The slot is read after the async writes of the slot that are still pending.
+	* @param	SlotName	Name of the save slot.
+	* @param	UserIndex	Index of the user the slot belongs to.
+	* @param	OnLoaded	Called on the game thread once the game has been loaded, or has failed to load.
+	* @return false if another game is still being loaded.
+	*/
+	UFUNCTION(BlueprintCallable, Category="GameManager")
+	bool LoadGameAsync( const FString& SlotName, int32 UserIndex, FOnGameLoaded OnLoaded );
+
+	/**
+	* Save the current game without blocking the game thread on the storage.
+	* The game is serialized right away on the game thread, the save slot is written on a worker thread,
+	* after the reads and writes of the slot that are still pending. @see SaveGame for the format of the slot.
+	* @param	SlotName	Name of the save slot.
+	* @param	UserIndex	Index of the user the slot belongs to.
+	* @param	OnSaved		Called on the game thread once the slot has been written, or has failed to be written.
+	* @return false if there is no game to save.
+	*/
+	UFUNCTION(BlueprintCallable, Category="GameManager")
+	bool SaveGameAsync( const FString& SlotName, int32 UserIndex, FOnGameSaved OnSaved );
+
+	/**
+	* Save only what has changed in the current game since it has been loaded from, or last delta saved to, the same slot.
+	* The record of that save is kept in memory and the changes are added to it as a delta, @see UGameObjectTree::SaveDeltaToRecord
+	* A full save is done the first time, or when the slot is not the one the game has been loaded from.
+	* @param	SlotName	Name of the save slot.
+	* @param	UserIndex	Index of the user the slot belongs to.
+	* @param	OnSaved		Called on the game thread once the slot has been written, or has failed to be written.
+	* @return false if there is no game to save.
+	*/
+	UFUNCTION(BlueprintCallable, Category="GameManager")
+	bool SaveGameDeltaAsync( const FString& SlotName, int32 UserIndex, FOnGameSaved OnSaved );
+
+	/** Whether a save slot is still being read or written by an async load or save. */
+	UFUNCTION(BlueprintPure, Category="GameManager")
+	bool HasPendingSaveGameIO() const;
+
+	/**
+	* Save the current game over several frames so that saving a big game does not hitch, @see UGameObjectTree::BeginIncrementalSave
+	* The saved game is the game as it was when this is called.
+	* @param	SlotName			Name of the save slot.
+	* @param	UserIndex			Index of the user the slot belongs to.
+	* @param	BudgetMilliseconds	Time to spend capturing objects per frame.
+	* @param	OnSaved				Called once the game has been written to the slot on a worker thread, or the save has failed.
+	* @return false if the save can not begin.
+	*/
+	UFUNCTION(BlueprintCallable, Category="GameManager")
+	bool SaveGameIncremental( const FString& SlotName, int32 UserIndex, float BudgetMilliseconds, FOnGameSaved OnSaved );
+
+	/** Whether an incremental save is in progress. */
+	UFUNCTION(BlueprintPure, Category="GameManager")
+	bool IsSavingGame() const;
+
 	// UGameInstance interface
 	virtual void Init() override;
 	virtual void Shutdown() override;
@@ -79,6 +146,13 @@ protected:
 	UPROPERTY( EditAnywhere, Category="GameManager", meta=(MetaClass="SaveGameObject", AllowAbstract="False") )
 	FStringClassReference SaveGameClass;
 
+	/**
+	* Codec the save games are compressed with, in chunks that are compressed on worker threads.
+	* Compressed save games are loaded regardless of this setting, run the GameObjectBenchmark commandlet to compare the codecs on a platform.
+	*/
+	UPROPERTY( EditAnywhere, BlueprintReadWrite, Category="GameManager" )
+	ESaveGameCompression SaveGameCompression;
+
 	/** The current running game. */
 	UPROPERTY( Transient )
 	UGame* CurrentGame;
@@ -101,5 +175,50 @@ protected:
 	UFUNCTION(BlueprintImplementableEvent, Category="GameManager", meta=(DisplayName="PostLoadGame"))
 	void BPF_PostLoadGame( USaveGameObject* SaveGame );
 
+private:
+
+	/** Save game object of the incremental save in progress. */
+	UPROPERTY(Transient)
+	USaveGameObject* PendingSaveGame;
+
+	FString PendingSaveSlotName;
+
+	int32 PendingSaveUserIndex;
+
+	FOnGameSaved PendingSaveCompleted;
+
+	void OnGameSavedToRecord( bool bSuccess, FGameRecord& Record );
+
+	/** Save game object the current game has been loaded from or last delta saved to, the next delta save adds to it. */
+	UPROPERTY(Transient)
+	USaveGameObject* DeltaSaveGame;
+
+	FString DeltaSaveSlotName;
+
+	int32 DeltaSaveUserIndex;
+
+	/** Number of save slots that are being read or written on worker threads. */
+	int32 NumPendingSaveGameIO;
+
+	bool bIsLoadingGame;
+
+	/** Create a save game object and save the current game into it, null if the game can not be saved. */
+	USaveGameObject* SaveCurrentGameToObject();
+
+	/** Load a game from a save game object that has been read from a slot. */
+	bool LoadGameFromObject( USaveGameObject* SaveGameObject, const FString& SlotName, int32 UserIndex );
+
+	/** Serialize a save game object and write it to a slot on a worker thread. */
+	void WriteSaveGameAsync( USaveGameObject* SaveGameObject, const FString& SlotName, int32 UserIndex, FOnGameSaved OnSaved );
+
+	/** Last read or write of each save slot dispatched on a worker thread, the next one of the same slot waits for it. */
+	TMap<FString, FGraphEventRef> SaveGameIOEvents;
+
+	/** Dispatch a read or write of a save slot on a worker thread, after the ones of the same slot that are still pending. */
+	void DispatchSaveGameIO( const FString& SlotName, int32 UserIndex, TFunction<void()> Task );
+
+	/** Wait on the game thread for the reads and writes of a save slot that have been dispatched on worker threads. */
+	void WaitForSaveGameIO( const FString& SlotName, int32 UserIndex );
+
 
 };
@@ -0,0 +1,37 @@
+// @Author Fathurahman <ipat.bogor@gmail.com> @ipatizer
+#pragma once
+
+#include "Stats/Stats.h"
+
+/** Memory of the current game's object tree, as of the last memory report, @see FGameObjectMemoryReport */
+DECLARE_STATS_GROUP( TEXT("GameObjectMemory"), STATGROUP_GameObjectMemory, STATCAT_Advanced );
+
+DECLARE_DWORD_COUNTER_STAT_EXTERN( TEXT("Objects"), STAT_GameObjectMemory_Objects, STATGROUP_GameObjectMemory, GAME_API );
+DECLARE_MEMORY_STAT_EXTERN( TEXT("Shallow"), STAT_GameObjectMemory_Shallow, STATGROUP_GameObjectMemory, GAME_API );
+DECLARE_MEMORY_STAT_EXTERN( TEXT("Deep"), STAT_GameObjectMemory_Deep, STATGROUP_GameObjectMemory, GAME_API );
+DECLARE_MEMORY_STAT_EXTERN( TEXT("Tags"), STAT_GameObjectMemory_Tags, STATGROUP_GameObjectMemory, GAME_API );
+DECLARE_MEMORY_STAT_EXTERN( TEXT("IDs"), STAT_GameObjectMemory_IDs, STATGROUP_GameObjectMemory, GAME_API );
+
+/** Where the frame time of the game modules goes, @see stat GameModules */
+DECLARE_STATS_GROUP( TEXT("GameModules"), STATGROUP_GameModules, STATCAT_Advanced );
+
+DECLARE_CYCLE_STAT_EXTERN( TEXT("Game Tick"), STAT_GameModules_GameTick, STATGROUP_GameModules, GAME_API );
+DECLARE_CYCLE_STAT_EXTERN( TEXT("Container Tick"), STAT_GameModules_ContainerTick, STATGROUP_GameModules, GAME_API );
+DECLARE_CYCLE_STAT_EXTERN( TEXT("Container SimulationTick"), STAT_GameModules_ContainerSimulationTick, STATGROUP_GameModules, GAME_API );
+DECLARE_CYCLE_STAT_EXTERN( TEXT("Tree Tick"), STAT_GameModules_TreeTick, STATGROUP_GameModules, GAME_API );
+DECLARE_CYCLE_STAT_EXTERN( TEXT("Tree SimulationTick"), STAT_GameModules_TreeSimulationTick, STATGROUP_GameModules, GAME_API );
+DECLARE_CYCLE_STAT_EXTERN( TEXT("Tree Parallel SimulationTick"), STAT_GameModules_TreeParallelSimulationTick, STATGROUP_GameModules, GAME_API );
+DECLARE_CYCLE_STAT_EXTERN( TEXT("Tree SaveToRecord"), STAT_GameModules_SaveToRecord, STATGROUP_GameModules, GAME_API );
+DECLARE_CYCLE_STAT_EXTERN( TEXT("Tree LoadFromRecord"), STAT_GameModules_LoadFromRecord, STATGROUP_GameModules, GAME_API );
+DECLARE_CYCLE_STAT_EXTERN( TEXT("SaveGame IO"), STAT_GameModules_SaveGameIO, STATGROUP_GameModules, GAME_API );
+DECLARE_CYCLE_STAT_EXTERN( TEXT("SaveGame Compress"), STAT_GameModules_SaveGameCompress, STATGROUP_GameModules, GAME_API );
+DECLARE_CYCLE_STAT_EXTERN( TEXT("SaveGame Decompress"), STAT_GameModules_SaveGameDecompress, STATGROUP_GameModules, GAME_API );
+DECLARE_CYCLE_STAT_EXTERN( TEXT("Tweener Tick"), STAT_GameModules_TweenerTick, STATGROUP_GameModules, GAME_API );
+DECLARE_CYCLE_STAT_EXTERN( TEXT("Widget NativeTick"), STAT_GameModules_WidgetTick, STATGROUP_GameModules, GAME_API );
+DECLARE_CYCLE_STAT_EXTERN( TEXT("DynamicCanvas NativeTick"), STAT_GameModules_DynamicCanvasTick, STATGROUP_GameModules, GAME_API );
+
+DECLARE_DWORD_COUNTER_STAT_EXTERN( TEXT("Objects Ticked"), STAT_GameModules_ObjectsTicked, STATGROUP_GameModules, GAME_API );
+DECLARE_DWORD_COUNTER_STAT_EXTERN( TEXT("Objects Simulation Ticked"), STAT_GameModules_ObjectsSimulationTicked, STATGROUP_GameModules, GAME_API );
+DECLARE_DWORD_COUNTER_STAT_EXTERN( TEXT("Tweens Active"), STAT_GameModules_TweensActive, STATGROUP_GameModules, GAME_API );
+DECLARE_DWORD_COUNTER_STAT_EXTERN( TEXT("Widgets Projected"), STAT_GameModules_WidgetsProjected, STATGROUP_GameModules, GAME_API );
+DECLARE_DWORD_COUNTER_STAT_EXTERN( TEXT("Records Serialized"), STAT_GameModules_RecordsSerialized, STATGROUP_GameModules, GAME_API );
@@ -70,6 +70,20 @@ enum class EImageFileFormat : uint8
 	ICNS    
 };
 
+/** Codecs save games can be compressed with, @see FChunkedCompression */
+UENUM(BlueprintType)
+enum class ESaveGameCompression : uint8
+{
+	/** Not compressed. */
+	None,
+
+	/** zlib, through FCompression. */
+	Zlib,
+
+	/** gzip, through FCompression. */
+	Gzip
+};
+
 //////////////////////////////////////////////////////////////////////////
 // Structs
 //////////////////////////////////////////////////////////////////////////
@@ -177,6 +191,26 @@ struct GAME_API FSaveGameArchive : public FObjectAndNameAsStringProxyArchive
 // Save Game Records
 //////////////////////////////////////////////////////////////////////////
 
+/** Versions of the game object tree record, records saved before versioning are version Initial. */
+namespace EGameObjectRecordVersion
+{
+	enum Type
+	{
+		/** Links refer to objects by name. */
+		Initial = 0,
+
+		/** Links refer to objects by their index in the object records. */
+		IndexedLinks,
+
+		/** A packed record can be followed by deltas that have to be merged into it. */
+		DeltaRecords,
+
+		// -----<new versions can be added above this line>-----
+		VersionPlusOne,
+		Latest = VersionPlusOne - 1
+	};
+}
+
 USTRUCT(BlueprintType)
 struct GAME_API FGameObjectRecord
 {
@@ -200,9 +234,74 @@ struct GAME_API FGameObjectLinkRecord
 {
     GENERATED_USTRUCT_BODY()
     
+	/** Index of the parent in the object records, INDEX_NONE for the tree itself. Since IndexedLinks. */
+	UPROPERTY()
+	int32 ParentIndex;
+
+	/** Indices of the children in the object records. Since IndexedLinks. */
+	UPROPERTY()
+	TArray<int32> ChildIndices;
+
+	/** Name of the parent, None for the tree itself. Only used by records older than IndexedLinks. */
 	UPROPERTY()
 	FName ParentName;
 
+	/** Names of the children. Only used by records older than IndexedLinks. */
+	UPROPERTY()
+	TArray<FName> ChildNames;
+
+	FGameObjectLinkRecord()
+		: ParentIndex( INDEX_NONE )
+	{}
+};
+
+/** An object that has changed since the previous save, or has been added to the tree since then. */
+USTRUCT()
+struct GAME_API FGameObjectDeltaRecord
+{
+	GENERATED_USTRUCT_BODY()
+
+	UPROPERTY()
+	FString ClassPath;
+
+	UPROPERTY()
+	FName Name;
+
+	UPROPERTY()
+	FName ID;
+
+	UPROPERTY()
+	TArray<uint8> ByteData;
+
+	/** Whether the object is a container, its children are then replaced by ChildNames. */
+	UPROPERTY()
+	bool bHasChildren = false;
+
+	UPROPERTY()
+	TArray<FName> ChildNames;
+};
+
+/** What has changed in an object tree since the previous save, @see UGameObjectTree::SaveDeltaToRecord */
+USTRUCT()
+struct GAME_API FGameObjectTreeDeltaRecord
+{
+	GENERATED_USTRUCT_BODY()
+
+	/** Objects that have left the tree, they are removed before the changed objects are applied. */
+	UPROPERTY()
+	TArray<FName> RemovedNames;
+
+	UPROPERTY()
+	TArray<FGameObjectDeltaRecord> ObjectRecords;
+
+	/** Data of the tree itself. */
+	UPROPERTY()
+	TArray<uint8> ByteData;
+
+	/** Whether the children of the tree have changed, they are then replaced by ChildNames. */
+	UPROPERTY()
+	bool bHasChildren = false;
+
 	UPROPERTY()
 	TArray<FName> ChildNames;
 };
@@ -212,6 +311,10 @@ struct GAME_API FGameObjectTreeRecord
 {
 	GENERATED_USTRUCT_BODY()
 
+	/** @see EGameObjectRecordVersion, records saved before it was added load as Initial. */
+	UPROPERTY()
+	int32 Version;
+
 	UPROPERTY()
 	TArray<FGameObjectRecord> ObjectRecords;
 
@@ -220,6 +323,22 @@ struct GAME_API FGameObjectTreeRecord
 
 	UPROPERTY()
 	TArray<uint8> ByteData;
+
+	/** The whole tree in the packed format, @see FPackedTreeRecordWriter. When it is not empty, the other records are empty. */
+	UPROPERTY()
+	TArray<uint8> PackedData;
+
+	/** Identifies PackedData as the base of the deltas, a tree only saves deltas into the record of the base it is tracking changes from. */
+	UPROPERTY()
+	FGuid BaseID;
+
+	/** Changes to merge into PackedData in order, @see UGameObjectTree::SaveDeltaToRecord */
+	UPROPERTY()
+	TArray<FGameObjectTreeDeltaRecord> Deltas;
+
+	FGameObjectTreeRecord()
+		: Version( EGameObjectRecordVersion::Initial )
+	{}
 };
 
 USTRUCT(BlueprintType)
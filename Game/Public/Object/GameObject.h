@@ -24,19 +24,94 @@ public:
 
 	friend class UGameObjectContainer;
 	friend class UGameObjectTree;
+	friend struct FGameObjectTickList;
 
-	/** Whether this object is allowed to do world tick. */
-	UPROPERTY(SaveGame, EditAnywhere, BlueprintReadWrite, Category="GameObject")
+	/**
+	* Whether this object is allowed to do world tick.
+	* In an object tree the objects tick in the order they have started ticking, not in the order of the tree: an object that is attached,
+	* or that starts ticking, ticks after the ones that already do, its descendants that start ticking with it tick after it.
+	* Use SetCanTick to change it at runtime, the tick lists are only updated by the setter.
+	*/
+	UPROPERTY(SaveGame, EditAnywhere, BlueprintReadOnly, Category="GameObject")
 	bool bCanTick = false;
 
-	/** Whether this object is allowed to do simulation tick. */
-	UPROPERTY(SaveGame, EditAnywhere, BlueprintReadWrite, Category="GameObject")
+	/**
+	* Whether this object is allowed to do simulation tick, in the same order as world tick, @see bCanTick
+	* Use SetCanSimulationTick to change it at runtime, the tick lists are only updated by the setter.
+	*/
+	UPROPERTY(SaveGame, EditAnywhere, BlueprintReadOnly, Category="GameObject")
 	bool bCanSimulationTick = false;			
 
+	/**
+	* Whether the simulation tick of this object and its descendants only reads and writes the objects in its own subtree.
+	* Such subtrees are simulated on worker threads in parallel with each other, Blueprint OnSimulationTick is not called for them,
+	* use OnSimulationTickSynced of the topmost thread safe object instead, it is called on the game thread after all of them are done.
+	*/
+	UPROPERTY(EditDefaultsOnly, Category="GameObject", AdvancedDisplay)
+	bool bThreadSafeSimulationTick = false;
+
+	/**
+	* Simulation time between two simulation ticks of this object, zero to do simulation tick on every tick.
+	* Objects with the same interval are spread evenly across ticks, each receives the simulation time that has passed since its previous simulation tick.
+	* Use SetSimulationTickInterval to change it at runtime.
+	*/
+	UPROPERTY(SaveGame, EditAnywhere, BlueprintReadOnly, Category="GameObject")
+	FTimespan SimulationTickInterval;
+
+	/**
+	* Whether disposing this object while it is in an object tree returns it to the tree's pool instead of destroying it,
+	* to be reused when an object of the same class is created for that tree. OnReturnedToPool must reset it to its default state.
+	* References to a pooled object stay valid, so they must not be kept past Dispose.
+	*/
+	UPROPERTY(EditDefaultsOnly, Category="GameObject", AdvancedDisplay)
+	bool bPoolable = false;
+
+	/**
+	* Whether packed records save this object through the precompiled layout of its SaveGame properties instead of Serialize.
+	* Turn it off for classes that save more than their SaveGame properties in Serialize.
+	*/
+	UPROPERTY(EditDefaultsOnly, Category="GameObject", AdvancedDisplay)
+	bool bUseSaveGameLayout = true;
+
+	/**
+	* Whether OnAddedToObjectTree and OnRemovedFromObjectTree are called on this object when one of its ancestors is moved between trees.
+	* They are always called on the object that is moved itself. Subtrees without such objects are moved without visiting them for events.
+	*/
+	UPROPERTY(EditDefaultsOnly, Category="GameObject", AdvancedDisplay)
+	bool bWantsObjectTreeEvents = false;
+
+	/** Set whether this object is allowed to do world tick. */
+	UFUNCTION(BlueprintCallable, Category="GameObject")
+	void SetCanTick( bool bFlag );
+
+	/** Set whether this object is allowed to do simulation tick. */
+	UFUNCTION(BlueprintCallable, Category="GameObject")
+	void SetCanSimulationTick( bool bFlag );
+
+	/** Set the simulation time between two simulation ticks of this object. */
+	UFUNCTION(BlueprintCallable, Category="GameObject")
+	void SetSimulationTickInterval( FTimespan InInterval );
+
+	/**
+	* Mark this object as changed since the previous delta save of its object tree, so the next delta save records it.
+	* The SaveGame properties set through their setters are marked automatically, call this before changing the others.
+	*/
+	UFUNCTION(BlueprintCallable, Category="GameObject")
+	void MarkSaveDirty();
+
+	/** Whether this object has changed since the previous delta save of its object tree. */
+	FORCEINLINE bool IsSaveDirty() const { return bSaveDirty; }
+
 	/** Get this object's ID. */
 	UFUNCTION(BlueprintPure, Category="ID")
 	FString GetID() const;
 
+	/** Get this object's interned ID, comparing and hashing it is as cheap as comparing and hashing an integer. */
+	FORCEINLINE const FName& GetIDName() const { return ID; }
+
+	/** Get the name this object is saved under, which identifies it in the records of its tree, @see SaveName */
+	FORCEINLINE FName GetSaveName() const { return SaveName.IsNone() ? GetFName() : SaveName; }
+
 	//////////////////////////////////////////////////////////////////////////
 
 	/**
@@ -66,6 +141,12 @@ public:
 	UFUNCTION(BlueprintPure, Category="GameObject")
 	virtual UGameObjectTree* GetObjectTree() const;
 
+	/** Get the number of ancestors of this object. */
+	FORCEINLINE int32 GetDepth() const { return Depth; }
+
+	/** Whether this object is waiting in the pool of an object tree to be reused. */
+	FORCEINLINE bool IsInPool() const { return bIsInPool; }
+
 	/** Do world tick, Called by the parent of this object (but you can call it manually too)
 	* @param DeltaSeconds	Seconds elapsed from the previous world tick.
 	*/
@@ -80,6 +161,7 @@ public:
 
 	/** 
 	* Remove this object from the object tree, do necessary clean up and mark it as pending kill.
+	* Poolable objects are returned to the pool of their object tree instead, disposing a pooled object does nothing.
 	* Note: Weak reference to this object (TWeakObjectPtr) will not be valid after disposing.
 	*		Strong reference to this object will need to check IsPendingKill()
 	*/
@@ -105,31 +187,106 @@ protected:
 	* but not with other objects in other containers.
 	*/
 	UPROPERTY(Transient)
-	FString ID;
+	FName ID;
 
 	/** Parent of this object.  */
 	UPROPERTY(Transient)
 	TWeakObjectPtr<UGameObjectContainer> Parent;
 
+	/** Index of the slot occupied by this object in its parent, INDEX_NONE if it does not occupy any. */
+	int32 SlotIndex = INDEX_NONE;
+
+	/** The object tree this object is attached to, kept up to date whenever this object or one of its ancestors is moved. */
+	UPROPERTY(Transient)
+	UGameObjectTree* OwningTree = nullptr;
+
+	/** Number of ancestors, kept up to date whenever this object or one of its ancestors is moved. */
+	int32 Depth = 0;
+
+	/** Index of this object in its object tree's class index, INDEX_NONE if it is not indexed. */
+	int32 ClassIndexSlot = INDEX_NONE;
+
+	/** 
+	* Position of this object in its object tree's depth first order, an object is an ancestor of another 
+	* if its interval contains the other's. Only valid while the tree's interval numbering is valid.
+	*/
+	int32 IntervalBegin = 0;
+	int32 IntervalEnd = 0;
+
+	/** Index of this object in its object tree's world tick list, INDEX_NONE if it is not registered. */
+	int32 WorldTickIndex = INDEX_NONE;
+
+	/** Index of this object in its object tree's simulation tick list or in its tick bucket, INDEX_NONE if it is not registered. */
+	int32 SimulationTickIndex = INDEX_NONE;
+
+	/** Index of this object in its object tree's parallel simulation roots, INDEX_NONE if it is not registered. */
+	int32 ParallelSimulationRootIndex = INDEX_NONE;
+
+	/** Index of the tick bucket this object is registered to, INDEX_NONE if it is not in a tick bucket. */
+	int32 SimulationTickBucketIndex = INDEX_NONE;
+
+	/** Simulation time of the object tree when this object was last simulation ticked from a tick bucket. */
+	FTimespan LastSimulationTickTime;
+
+	/** Whether this object is in the pool of an object tree. */
+	bool bIsInPool = false;
+
+	/** The object tree whose pool counts this poolable object as active, it has been handed out by its pool or it is in the tree. */
+	TWeakObjectPtr<UGameObjectTree> PoolCountingTree;
+
+	/** Index of this object in the incremental save of its object tree, INDEX_NONE if it is not waiting to be captured. */
+	int32 SaveCaptureIndex = INDEX_NONE;
+
+	/** Whether this object is in the dirty objects of its object tree, @see MarkSaveDirty */
+	bool bSaveDirty = false;
+
+	/**
+	* The name this object has been loaded under when another object already had it, None to be saved under its own name.
+	* Deltas are merged by name, so the object keeps the name it has in the record.
+	*/
+	FName SaveName;
+
+	/** Set a SaveGame property, marking this object as dirty first if the value changes. @return whether the value has changed. */
+	template<typename T>
+	FORCEINLINE bool SetSaveGameProperty( T& Property, const T& Value )
+	{
+		if ( Property == Value )
+		{
+			return false;
+		}
+		MarkSaveDirty();
+		Property = Value;
+		return true;
+	}
+
+	/** Dispose this object, returning it to the pool of an object tree if it is poolable and the pool has room. */
+	void Dispose_Internal( UGameObjectTree* InPoolTree );
+
 protected:
 	
-	/** Called after this object is added to a game object tree. */
-	virtual void OnAddedToObjectTree(UGameObjectTree* ToObjectTree) { ReceiveAddedToObjectTree(ToObjectTree); }
+	/** Called after this object, or one of its ancestors if bWantsObjectTreeEvents is set, is added to a game object tree. */
+	virtual void OnAddedToObjectTree(UGameObjectTree* ToObjectTree);
 
-	/** Called after this object is removed from a game object tree. */
-	virtual void OnRemovedFromObjectTree(UGameObjectTree* FromObjectTree) { ReceiveRemovedFromObjectTree(FromObjectTree); }
+	/** Called after this object, or one of its ancestors if bWantsObjectTreeEvents is set, is removed from a game object tree. */
+	virtual void OnRemovedFromObjectTree(UGameObjectTree* FromObjectTree);
 
 	/** Called after this object is added as a child to a parent. */
-	virtual void OnAddedToParent(UGameObjectContainer* ToParent) { ReceiveAddedToParent(ToParent); }
+	virtual void OnAddedToParent(UGameObjectContainer* ToParent);
 
 	/** Called after this object is removed from a parent. */
-	virtual void OnRemovedFromParent(UGameObjectContainer* FromParent) { ReceiveRemovedFromParent(FromParent); }
+	virtual void OnRemovedFromParent(UGameObjectContainer* FromParent);
 
 	/** Called after this object has been loaded from a save game. */
-	virtual void OnLoaded() { ReceiveLoaded(); }
+	virtual void OnLoaded();
 
 	/** Called before this object is marked pending kill. */
-	virtual void OnDispose() { ReceiveDispose(); }
+	virtual void OnDispose();
+
+	/** Called on the game thread after this thread safe subtree and all the others have been simulated. */
+	virtual void OnSimulationTickSynced( const FTimespan& Timespan );
+
+	/** Called instead of OnDispose when this object is returned to the pool of an object tree, reset it to its default state here. */
+	virtual void OnReturnedToPool( UGameObjectTree* Pool );
 
 	//////////////////////////////////////////////////////////////////////////
 
@@ -155,6 +312,10 @@ protected:
 	UFUNCTION(BlueprintImplementableEvent, Category="Tick|Event", meta=(DisplayName="OnSimulationTick"))
 	void ReceiveSimulationTick(FTimespan Timespan);
 
+	/** Event triggered on the game thread after this thread safe subtree and all the others have been simulated. */
+	UFUNCTION(BlueprintImplementableEvent, Category="Tick|Event", meta=(DisplayName="OnSimulationTickSynced"))
+	void ReceiveSimulationTickSynced(FTimespan Timespan);
+
 	/** Event triggered after the Game is loaded. */
 	UFUNCTION(BlueprintImplementableEvent, Category="GameObject|Event", meta=(DisplayName="OnLoaded"))
 	void ReceiveLoaded();
@@ -167,4 +328,8 @@ protected:
 	UFUNCTION(BlueprintImplementableEvent, Category="GameObject|Event", meta=(DisplayName="OnDispose"))
 	void ReceiveDispose();
 
+	/** Event triggered when this object is returned to a pool instead of being disposed, reset it to its default state here. */
+	UFUNCTION(BlueprintImplementableEvent, Category="GameObject|Event", meta=(DisplayName="OnReturnedToPool"))
+	void ReceiveReturnedToPool(UGameObjectTree* Pool);
+
 };
@@ -6,6 +6,106 @@
 #include "GameObject.h"
 #include "GameObjectContainer.generated.h"
 
+/**
+* Handle to a child of a game object container.
+* The handle refers to the child's slot, the generation makes sure that a stale handle never resolves 
+* to another child that happens to reuse the same slot.
+*/
+struct GAME_API FGameObjectHandle
+{
+	int32 Index;
+
+	uint32 Generation;
+
+	FGameObjectHandle()
+		: Index( INDEX_NONE )
+		, Generation( 0 )
+	{
+	}
+
+	FGameObjectHandle( int32 InIndex, uint32 InGeneration )
+		: Index( InIndex )
+		, Generation( InGeneration )
+	{
+	}
+
+	FORCEINLINE bool IsValid() const { return Index != INDEX_NONE; }
+
+	FORCEINLINE bool operator==( const FGameObjectHandle& Other ) const { return Index == Other.Index && Generation == Other.Generation; }
+
+	FORCEINLINE bool operator!=( const FGameObjectHandle& Other ) const { return !( *this == Other ); }
+};
+
+/** A slot in a container's children storage, a slot that has no object is free to be reused. */
+USTRUCT()
+struct GAME_API FGameObjectSlot
+{
+	GENERATED_USTRUCT_BODY()
+
+	UPROPERTY()
+	UGameObject* Object = nullptr;
+
+	/** Incremented every time the slot is released. */
+	uint32 Generation = 0;
+};
+
+/** Kinds of change to a container's children storage that can be deferred. */
+enum class EGameObjectChildCommand : uint8
+{
+	/** Give a child that has been added a slot. */
+	Add,
+
+	/** Make the slot of a child that has been removed free to be reused. */
+	Remove,
+};
+
+/** A change to a container's children storage that is deferred until its children are unlocked. */
+USTRUCT()
+struct GAME_API FGameObjectChildCommand
+{
+	GENERATED_USTRUCT_BODY()
+
+	/** The added child, nullptr for remove commands and for add commands that have been cancelled. */
+	UPROPERTY()
+	UGameObject* Object = nullptr;
+
+	/** The slot that has been released, for remove commands. */
+	int32 SlotIndex = INDEX_NONE;
+
+	EGameObjectChildCommand Type = EGameObjectChildCommand::Add;
+
+	FGameObjectChildCommand() {}
+
+	FGameObjectChildCommand( EGameObjectChildCommand InType, UGameObject* InObject, int32 InSlotIndex )
+		: Object( InObject )
+		, SlotIndex( InSlotIndex )
+		, Type( InType )
+	{
+	}
+};
+
+/** Whether ForEachDescendant visits an object before or after its descendants. */
+enum class EGameObjectTraversalOrder : uint8
+{
+	PreOrder,
+	PostOrder,
+};
+
+/** Options for ForEachDescendant. */
+struct FGameObjectTraversalOptions
+{
+	/** How deep to go, 1 only visits the children, 0 or less visits every descendant. */
+	int32 MaxDepth;
+
+	EGameObjectTraversalOrder Order;
+
+	FGameObjectTraversalOptions( int32 InMaxDepth = 0, EGameObjectTraversalOrder InOrder = EGameObjectTraversalOrder::PreOrder )
+		: MaxDepth( InMaxDepth )
+		, Order( InOrder )
+	{
+	}
+};
+
 /**
 * Game Object Container.
 * As the name implies, this object that can contain another game object(s) as its children.
@@ -22,9 +122,16 @@ public:
 	// Unreal Properties and Functions
 	//////////////////////////////////////////////////////////////////////////
 
-	/** Whether to allow children to tick (either World or Simulation tick). */
-	UPROPERTY(SaveGame, EditAnywhere, BlueprintReadWrite, Category="GameObjectContainer")
+	/**
+	* Whether to allow children to tick (either World or Simulation tick).
+	* Use SetAllowChildrenToTick to change it at runtime, the tick lists are only updated by the setter.
+	*/
+	UPROPERTY(SaveGame, EditAnywhere, BlueprintReadOnly, Category="GameObjectContainer")
 	bool bAllowChildrenToTick = false;	
+
+	/** Set whether to allow children to tick. */
+	UFUNCTION(BlueprintCallable, Category="GameObjectContainer")
+	void SetAllowChildrenToTick( bool bFlag );
     
 	/**
 	* Check whether this container is one of the ancestor of another object.
@@ -64,6 +171,26 @@ public:
 	UFUNCTION(BlueprintCallable, Category="GameObjectContainer", meta=(DisplayName="GetOrCreateChild"))
 	UGameObject* BPF_GetOrCreateChild( TSubclassOf<UGameObject> InClass, const FString& InID );
 
+	/**
+	* Create many children of the same class at once, each with a generated ID.
+	* @param	InClass			The children's class.
+	* @param	InCount			Number of children to create.
+	* @param	bNotifyEach		Whether to trigger the per-child events of this container, OnChildrenAdded and the object tree events are triggered either way.
+	* @param	OutChildren		The created children that have been added, the ones that could not be added are disposed.
+	*/
+	UFUNCTION(BlueprintCallable, Category="GameObjectContainer", meta=(DisplayName="CreateChildren"))
+	void BPF_CreateChildren( TSubclassOf<UGameObject> InClass, int32 InCount, bool bNotifyEach, TArray<UGameObject*>& OutChildren );
+
+	/**
+	* Add many objects as children of this container at once, each with a generated ID.
+	* Objects that can't be added are skipped.
+	* @param	InChildren		The objects to be added.
+	* @param	bNotifyEach		Whether to trigger the per-child events of this container, OnChildrenAdded and the object tree events are triggered either way.
+	* @return the number of children added.
+	*/
+	UFUNCTION(BlueprintCallable, Category="GameObjectContainer")
+	int32 AddChildren( const TArray<UGameObject*>& InChildren, bool bNotifyEach = false );
+
 	/**
 	* Removes a child from this container
 	* @param	InChild		Child to be removed
@@ -74,6 +201,7 @@ public:
 
 	/**
 	* Removes all children from this container.
+	* On an object tree this also discards the children that have not been loaded yet, @see UGameObjectTree::LoadFromRecord
 	* @param	bDispose	Whether to dispose the removed children.
 	*/
 	UFUNCTION(BlueprintCallable, Category="GameObjectContainer")
@@ -85,6 +213,12 @@ public:
 	UFUNCTION(BlueprintPure, Category="GameObjectContainer", meta=(DisplayName="GetChildren"))
 	void GetChildren( TArray<UGameObject*>& OutChildren ) const;
 
+	/**
+	* Get the number of children of this container.
+	*/
+	UFUNCTION(BlueprintPure, Category="GameObjectContainer")
+	int32 GetNumChildren() const;
+
 	/**
 	* Find a child with some specific criteria.
 	* @param 	InClass			The child's class, if this is not specified then any class will do.
@@ -170,6 +304,20 @@ public:
 	/** Constructor. */
     UGameObjectContainer(const FObjectInitializer& ObjectInitializer);
 
+	/**
+	* Get a handle to a child of this container.
+	* @param	InChild		The child.
+	* @return an invalid handle if InChild is not a child of this container.
+	*/
+	FGameObjectHandle GetChildHandle( const UGameObject* InChild ) const;
+
+	/**
+	* Resolve a child handle.
+	* @param	Handle		Handle that was previously returned by GetChildHandle.
+	* @return nullptr if the child has been removed from this container since the handle was created.
+	*/
+	UGameObject* ResolveChildHandle( const FGameObjectHandle& Handle ) const;
+
 	/**
 	* Find a specific child in this container that meets some certain criteria.
 	* @param	InClass		The child's class, if this is not specified then any class will do.
@@ -178,7 +326,7 @@ public:
 	* @return the first child that meets the criteria.
 	*/
 	template<class T=UGameObject>
-	FORCEINLINE T* FindChild( TSubclassOf<T> InClass, const FString& InID = TEXT(""), const FString& InTag = TEXT("") ) const 
+	FORCEINLINE T* FindChild( TSubclassOf<T> InClass, const FName& InID = NAME_None, const FString& InTag = TEXT("") ) const 
 	{
 		return Cast<T>( FindChild_Internal( InClass, InID, InTag, false  ) );
 	}
@@ -190,7 +338,7 @@ public:
 	* @return the first child that meets the criteria.
 	*/
 	template<class T=UGameObject>
-	FORCEINLINE T* FindChild( const FString& InID = TEXT(""), const FString& InTag = TEXT("") ) const
+	FORCEINLINE T* FindChild( const FName& InID = NAME_None, const FString& InTag = TEXT("") ) const
 	{
 		return Cast<T>( FindChild_Internal( T::StaticClass(), InID, InTag, false ) );
 	}
@@ -200,10 +348,10 @@ public:
 	* @param	InClass		The descendant's class.
 	* @param	InID		The descendant's ID, if this is not specified then any ID will do.
 	* @param	InTag		The descendant's Tag, if this is not specified then any Tag will do.
-	* @return the first descendant that meets the criteria.
+	* @return the first descendant that meets the criteria, the children are looked at first, then the descendants in depth first order.
 	*/
 	template<class T=UGameObject>
-	FORCEINLINE T* FindDescendant( TSubclassOf<T> InClass, const FString& InID = TEXT(""), const FString& InTag = TEXT("") ) const
+	FORCEINLINE T* FindDescendant( TSubclassOf<T> InClass, const FName& InID = NAME_None, const FString& InTag = TEXT("") ) const
 	{
 		return Cast<T>( FindChild_Internal( *InClass ? InClass : T::StaticClass(), InID, InTag, true ) );
 	}
@@ -212,10 +360,10 @@ public:
 	* Find a specific descendant in this container that meets some certain criteria.
 	* @param	InID		The descendant's ID, if this is not specified then any ID will do.
 	* @param	InTag		The descendant's Tag, if this is not specified then any Tag will do.
-	* @return the first descendant that meets the criteria.
+	* @return the first descendant that meets the criteria, the children are looked at first, then the descendants in depth first order.
 	*/
 	template<class T=UGameObject>
-	FORCEINLINE T* FindDescendant( const FString& InID = TEXT(""), const FString& InTag = TEXT("") ) const
+	FORCEINLINE T* FindDescendant( const FName& InID = NAME_None, const FString& InTag = TEXT("") ) const
 	{
 		return Cast<T>( FindChild_Internal( T::StaticClass(), InID, InTag, true ) );
 	}
@@ -256,7 +404,7 @@ public:
 	* @param[out]	OutDescendants	The find result
 	* @param[in]	InClass			The descendant's class.
 	* @param[in]	InTag			The descendant's tag, if this is not specified then any Tag will do.
-	* @return the number of descendants that match the criteria.
+	* @return the number of descendants that match the criteria, in depth first order.
 	*/
 	template<class T=UGameObject>
 	FORCEINLINE int32 FindDescendants( TArray<T*>& OutDescendants,  TSubclassOf<T> InClass, const FString& InTag = TEXT("") ) const 
@@ -271,7 +419,7 @@ public:
 	* Find descendants that meets some certain criteria.
 	* @param[out]	OutDescendants	The find result
 	* @param[in]	InTag			The descendant's tag, if this is not specified then any Tag will do.
-	* @return the number of descendants that match the criteria.
+	* @return the number of descendants that match the criteria, in depth first order.
 	*/
 	template<class T=UGameObject>
 	FORCEINLINE int32 FindDescendants( TArray<T*>& OutDescendants, const FString& InTag = TEXT("") ) const 
@@ -282,6 +430,21 @@ public:
 		return Num;
 	}
 
+	/**
+	* Visit the descendants of this container depth first without allocating anything.
+	* Children added during the visit may or may not be visited, removed children are not visited.
+	* @param	Predicate	Called as bool( UGameObject* ) for every descendant, only those that pass it are visited. 
+	*						It does not stop the descendants of an object that fails it from being visited.
+	* @param	Visitor		Called as bool( UGameObject* ) for every descendant that passes the predicate, return false to stop.
+	* @param	Options		Depth limit and order.
+	* @return false if the visitor stopped the visit.
+	*/
+	template<typename PredicateType, typename VisitorType>
+	bool ForEachDescendant( const PredicateType& Predicate, const VisitorType& Visitor, const FGameObjectTraversalOptions& Options = FGameObjectTraversalOptions() ) const
+	{
+		return ForEachDescendant_Recursive( Predicate, Visitor, Options, 1 );
+	}
+
 	/**
 	* Add a child to this container.
 	* @note Operation will fail If the child to be added is an ancestor of this container.
@@ -292,7 +455,7 @@ public:
 	*									the existing child will be replaced if this flag is true.
 	* @return false if the operation failed.
 	*/
-	UGameObject* AddChild( UGameObject* InChild, const FString& InChildID = TEXT(""), bool bOverwrite = true );
+	UGameObject* AddChild( UGameObject* InChild, const FName& InChildID = NAME_None, bool bOverwrite = true );
 
 	/**
 	* Create and add a child to this container.
@@ -303,7 +466,7 @@ public:
 	*									the existing child will be replaced if this flag is true.
 	*/
 	template<class T=UGameObject>
-	FORCEINLINE T* CreateChild( TSubclassOf<T> InClass, const FString& InID, bool bOverwrite = false )
+	FORCEINLINE T* CreateChild( TSubclassOf<T> InClass, const FName& InID = NAME_None, bool bOverwrite = false )
 	{
 		return Cast<T>( CreateChild_Internal( *InClass ? InClass : T::StaticClass(), InID, bOverwrite ) );
 	}
@@ -316,11 +479,28 @@ public:
 	*									the existing child will be replaced if this flag is true.
 	*/
 	template<class T=UGameObject>
-	FORCEINLINE T* CreateChild( const FString& InID, bool bOverwrite = false )
+	FORCEINLINE T* CreateChild( const FName& InID = NAME_None, bool bOverwrite = false )
 	{
 		return Cast<T>( CreateChild_Internal( T::StaticClass(), InID, bOverwrite) );
 	}
 
+	/**
+	* Create many children of the same class at once, each with a generated ID.
+	* @param[out]	OutChildren		The created children that have been added, the ones that could not be added are disposed.
+	* @param[in]	InClass			The children's class.
+	* @param[in]	InCount			Number of children to create.
+	* @param[in]	bNotifyEach		Whether to trigger the per-child events of this container, OnChildrenAdded and the object tree events are triggered either way.
+	* @return the number of children added, which is the number of children in OutChildren.
+	*/
+	template<class T=UGameObject>
+	FORCEINLINE int32 CreateChildren( TArray<T*>& OutChildren, TSubclassOf<T> InClass, int32 InCount, bool bNotifyEach = false )
+	{
+		TArray<UGameObject*> Objects;
+		int32 Num = CreateChildren_Internal( *InClass ? InClass : T::StaticClass(), InCount, Objects, bNotifyEach );
+		ReinterpretObjectArray( Objects, OutChildren );
+		return Num;
+	}
+
 	/**
 	* Get an existing child, if it does not exist then create a new one.
 	* @param	InClass		The child's class.
@@ -328,7 +508,7 @@ public:
 	* @return the child.
 	*/
 	template<class T=UGameObject>
-	FORCEINLINE T* GetOrCreateChild( TSubclassOf<T> InClass, const FString& InID )
+	FORCEINLINE T* GetOrCreateChild( TSubclassOf<T> InClass, const FName& InID )
 	{
 		return Cast<T>( GetOrCreateChild_Internal( *InClass ? InClass : T::StaticClass(), InID ) );
 	}
@@ -340,31 +520,54 @@ public:
 	* @return the child.
 	*/
 	template<class T=UGameObject>
-	FORCEINLINE T* GetOrCreateChild( const FString& InID )
+	FORCEINLINE T* GetOrCreateChild( const FName& InID )
 	{
 		return Cast<T>( GetOrCreateChild_Internal( T::StaticClass(), InID ) );
 	}
 
 
 	// UGameObject interface
+	/** 
+	* Children are only ticked from here when this container is not attached to an object tree,
+	* otherwise the object tree ticks them from its tick lists.
+	*/
 	virtual void Tick(float DeltaTime) override;
 	virtual void SimulationTick(const FTimespan& Timespan) override;
 	// End of UGameObject interface
 
-protected:
+	// UObject interface
+	virtual SIZE_T GetResourceSize( EResourceSizeMode::Type Mode ) override;
+	// End of UObject interface
 
-	typedef TMap<FString, UGameObject*> FGameObjectMap;
-	typedef TPair<FString, UGameObject*> FGameObjectPair;
+protected:
 
-	/** Children of this container. This should not be edited manually, please use the various children manipulation functions. */
+	/** 
+	* Children of this container, stored in a slot map so iterating them is a linear walk with a stable order.
+	* This should not be edited manually, please use the various children manipulation functions. 
+	*/
 	UPROPERTY()
-	TMap<FString, UGameObject*> Children;
+	TArray<FGameObjectSlot> ChildSlots;
+
+	/** Released slots that can be reused by new children. */
+	TArray<int32> FreeChildSlots;
+
+	/** Maps a child's ID to its slot. */
+	TMap<FName, int32> ChildSlotsByID;
+
+	/** The next suffix to try when generating a unique ID, per base ID. */
+	TMap<FName, int32> NextUniqueIDSuffixes;
+
+	/** Number of occupied slots. */
+	int32 NumChildren;
 	
 	/** Called after a child has been added to this container. */
-	virtual void OnChildAdded(UGameObject* Child) { ReceiveChildAdded(Child); }
+	virtual void OnChildAdded(UGameObject* Child);
 
 	/** Called after a child has been removed from this container. */
-	virtual void OnChildRemoved(UGameObject* Child) { ReceiveChildRemoved(Child); }
+	virtual void OnChildRemoved(UGameObject* Child);
+
+	/** Called once after a batch of children has been added by AddChildren or CreateChildren. */
+	virtual void OnChildrenAdded( const TArray<UGameObject*>& Children );
 
 	/** Event triggered after a new child has been added. */
 	UFUNCTION(BlueprintImplementableEvent, Category="GameObjectContainer|Event", meta=(DisplayName="OnChildAdded"))
@@ -374,32 +577,142 @@ protected:
 	UFUNCTION(BlueprintImplementableEvent, Category="GameObjectContainer|Event", meta=(DisplayName="OnChildRemoved"))
 	void ReceiveChildRemoved(UGameObject* Child);
 
+	/** Event triggered once after a batch of children has been added. */
+	UFUNCTION(BlueprintImplementableEvent, Category="GameObjectContainer|Event", meta=(DisplayName="OnChildrenAdded"))
+	void ReceiveChildrenAdded( const TArray<UGameObject*>& Children );
+
 	// UGameObject protected interface
-	virtual void OnAddedToObjectTree(UGameObjectTree* ToObjectTree) override;
-	virtual void OnRemovedFromObjectTree(UGameObjectTree* FromObjectTree) override;
 	virtual void OnDispose() override;
+	virtual void OnReturnedToPool( UGameObjectTree* Pool ) override;
 	// End of UGameObject protected interface
 
 private:
 
-	UGameObject* CreateChild_Internal( UClass* InClass, const FString& InID, bool bOverwrite );
+	UGameObject* CreateChild_Internal( UClass* InClass, const FName& InID, bool bOverwrite );
+
+	UGameObject* GetOrCreateChild_Internal( UClass* InClass, const FName& InID );
 
-	UGameObject* GetOrCreateChild_Internal( UClass* InClass, const FString& InID );
+	int32 CreateChildren_Internal( UClass* InClass, int32 InCount, TArray<UGameObject*>& OutChildren, bool bNotifyEach );
 
-	UGameObject* FindChild_Internal( UClass* InClass, const FString& InID, const FString& InTag, bool bRecursive ) const;
+	/** Whether an object can be added as a child of this container. */
+	bool CanAddChild( UGameObject* InChild ) const;
+
+	/** Attach a child that passed CanAddChild under an ID that is free, optionally triggering the per-child events. The trees are always notified. */
+	void AttachChild( UGameObject* InChild, const FName& ChildID, bool bNotify );
+
+	UGameObject* FindChild_Internal( UClass* InClass, const FName& InID, const FString& InTag, bool bRecursive ) const;
 
 	int32 FindChildren_Internal( UClass* InClass, const FString& InTag, TArray<UGameObject*>& OutObjects, bool bRecursive ) const;
 
-	void GenerateUniqueID( UObject* Object, FString& OutID );
+	/** Generate an ID that is unique among the children of this container, in constant time. */
+	FName GenerateUniqueID( UObject* Object );
+
+	/** Find a child by its ID, returns nullptr if there's no such child. */
+	UGameObject* FindChildByID( const FName& InID ) const;
 
+	/** Put a child in a free slot and index it by its ID. */
+	void AllocateChildSlot( UGameObject* InChild );
+
+	/** Release the slot of a child and remove it from the ID index. */
+	void ReleaseChildSlot( UGameObject* InChild );
+
+	template<typename PredicateType, typename VisitorType>
+	bool ForEachDescendant_Recursive( const PredicateType& Predicate, const VisitorType& Visitor, const FGameObjectTraversalOptions& Options, int32 InDepth ) const
+	{
+		// Indices instead of iterators, so the slots can grow while visiting.
+		for ( int32 Index = 0; Index < ChildSlots.Num(); Index++ )
+		{
+			UGameObject* Child = ChildSlots[Index].Object;
+			if ( Child && Child->Parent.Get() == this && Child->IsPendingKill() == false )
+			{
+				if ( !VisitDescendant( Child, Predicate, Visitor, Options, InDepth ) )
+				{
+					return false;
+				}
+			}
+		}
+		for ( int32 Index = 0; Index < DeferredChildCommands.Num(); Index++ )
+		{
+			UGameObject* Child = GetDeferredChild( DeferredChildCommands[Index] );
+			if ( Child && Child->IsPendingKill() == false )
+			{
+				if ( !VisitDescendant( Child, Predicate, Visitor, Options, InDepth ) )
+				{
+					return false;
+				}
+			}
+		}
+		return true;
+	}
+
+	template<typename PredicateType, typename VisitorType>
+	static bool VisitDescendant( UGameObject* Object, const PredicateType& Predicate, const VisitorType& Visitor, const FGameObjectTraversalOptions& Options, int32 InDepth )
+	{
+		const bool bPassed = Predicate( Object );
+		if ( bPassed && Options.Order == EGameObjectTraversalOrder::PreOrder && !Visitor( Object ) )
+		{
+			return false;
+		}
+
+		if ( Options.MaxDepth <= 0 || InDepth < Options.MaxDepth )
+		{
+			const UGameObjectContainer* Container = Cast<UGameObjectContainer>( Object );
+			if ( Container && !Container->ForEachDescendant_Recursive( Predicate, Visitor, Options, InDepth + 1 ) )
+			{
+				return false;
+			}
+		}
+
+		if ( bPassed && Options.Order == EGameObjectTraversalOrder::PostOrder && !Visitor( Object ) )
+		{
+			return false;
+		}
+		return true;
+	}
+
+	/** 
+	* Set the object tree and depth of an object that has just been moved and of all its descendants, recounting their tree event listeners.
+	* @return the tree event listener weight of the object, @see GetTreeEventListenerWeight
+	*/
+	static int32 SetObjectTreeAndDepth( UGameObject* Root, UGameObjectTree* InObjectTree, int32 InDepth );
+
+	/** Number of descendants that want object tree events, @see UGameObject::bWantsObjectTreeEvents */
+	int32 NumTreeEventListeners = 0;
+
+	/** Number of objects that want object tree events in the subtree of an object, the object included. */
+	static int32 GetTreeEventListenerWeight( const UGameObject* Object );
+
+	/** Add to the listener count of this container and all of its ancestors. */
+	void AdjustTreeEventListeners( int32 Delta );
+
+	/** Call the object tree event on every descendant that wants it, skipping the subtrees that have none. */
+	void NotifyTreeEventListeners( UGameObjectTree* InObjectTree, bool bAdded );
+
+	/** Get the child of an add command that still has to be given a slot, nullptr if there's none. */
+	UGameObject* GetDeferredChild( const FGameObjectChildCommand& Command ) const;
+
+	/** Dispose all children of this container that has just been detached, returning the poolable ones to a pool if there's one. */
+	void DisposeChildren( UGameObjectTree* InPoolTree );
+
+	/** Cancel the add command of a child that is removed before the children are unlocked. */
+	void CancelDeferredAdd( UGameObject* InChild );
+
+	/**
+	* Lock the children slots so they can be iterated safely while children are added and removed.
+	* While locked, adding and removing children takes effect immediately (parent, ID lookups, events and ticking) 
+	* but no slot becomes occupied or free, instead the changes are recorded as commands and applied in order when unlocked.
+	* So children added while locked are not visited by the iteration, and removed children are skipped.
+	* Moving a child to another container is a remove command in its old container and an add command in the new one.
+	* @return false if the children are already locked.
+	*/
 	bool LockChildren();
 
+	/** Unlock the children slots and apply the deferred commands, the cost scales with the number of commands. */
 	void UnlockChildren();
 
 	bool bIsChildrenLocked;
 
-	bool bIsChildrenDirty;
-
+	/** Changes to the children slots that are deferred until the children are unlocked, in the order they were made. */
 	UPROPERTY(Transient)
-	TArray<UGameObject*> PendingAddedChildren;
+	TArray<FGameObjectChildCommand> DeferredChildCommands;
 };
\ No newline at end of file
@@ -5,6 +5,148 @@
 #include "GameObjectContainer.h"
 #include "GameObjectTree.generated.h"
 
+class FPackedTreeRecordWriter;
+class FPackedTreeRecordReader;
+struct FGameObjectDeferredRecord;
+
+/**
+* A flat list of objects that need to be ticked.
+* Removing an object only clears its entry, the list is compacted after it has been iterated,
+* so the order of the remaining objects never changes and removing while iterating is safe.
+*/
+USTRUCT()
+struct GAME_API FGameObjectTickList
+{
+	GENERATED_USTRUCT_BODY()
+
+	UPROPERTY(Transient)
+	TArray<UGameObject*> Objects;
+
+	/** Number of cleared entries. */
+	int32 NumRemoved = 0;
+
+	/** Add an object to the end of this list. */
+	void Add( UGameObject* Object, int32 UGameObject::* IndexMember );
+
+	/** Remove an object from this list, does nothing if the object is not in the list. */
+	void Remove( UGameObject* Object, int32 UGameObject::* IndexMember );
+
+	/** Remove the cleared entries. */
+	void Compact( int32 UGameObject::* IndexMember );
+
+	/** Remove all objects. */
+	void Reset( int32 UGameObject::* IndexMember );
+};
+
+/**
+* Objects that receive simulation tick once per the same interval.
+* Each tick only a share of the objects proportional to the elapsed simulation time is ticked, in round robin,
+* so the cost is spread evenly across ticks instead of every object being ticked in the same tick.
+*/
+USTRUCT()
+struct GAME_API FGameObjectTickBucket
+{
+	GENERATED_USTRUCT_BODY()
+
+	/** Simulation time between two simulation ticks of each object. */
+	FTimespan Interval;
+
+	UPROPERTY(Transient)
+	FGameObjectTickList List;
+
+	/** Index of the next object to tick. */
+	int32 Cursor = 0;
+
+	/** Number of objects that are due but not ticked yet, the fraction is carried to the next tick. */
+	double Progress = 0.0;
+
+	/** Remove the cleared entries while keeping the cursor on the same object. */
+	void Compact();
+};
+
+/** Disposed objects of one class that are kept to be reused. */
+USTRUCT()
+struct GAME_API FGameObjectPool
+{
+	GENERATED_USTRUCT_BODY()
+
+	UPROPERTY(Transient)
+	UClass* Class = nullptr;
+
+	/** The pooled objects, the last one is reused first. */
+	UPROPERTY(Transient)
+	TArray<UGameObject*> Objects;
+
+	/** Number of objects of the class that have been handed out by the pool or are in the tree, whether they come from the pool or not. */
+	int32 NumActive = 0;
+
+	/** The highest NumActive has ever been. */
+	int32 HighWaterMark = 0;
+};
+
+/** An object and the simulation time it has to be ticked with. */
+struct FGameObjectSimulationTick
+{
+	UGameObject* Object;
+	FTimespan Timespan;
+
+	/** Objects of a thread safe subtree that have changed while it was simulated, merged into the tree's dirty objects at the sync point. */
+	TArray<UGameObject*> SaveDirtyObjects;
+
+	FGameObjectSimulationTick( UGameObject* InObject, const FTimespan& InTimespan )
+		: Object( InObject ), Timespan( InTimespan )
+	{}
+};
+
+/** Called when an incremental save of an object tree is done, with whether it has succeeded and the record it has been saved into. */
+DECLARE_DELEGATE_TwoParams( FOnGameObjectTreeSaved, bool /*bSuccess*/, FGameObjectTreeRecord& /*Record*/ );
+
+/** State of an incremental save of an object tree, @see UGameObjectTree::BeginIncrementalSave */
+USTRUCT()
+struct GAME_API FGameObjectSaveCapture
+{
+	GENERATED_USTRUCT_BODY()
+
+	/** The objects to capture in depth first order, each one is cleared once it has been captured. */
+	UPROPERTY(Transient)
+	TArray<UGameObject*> Objects;
+
+	/** Index of the parent of each object, INDEX_NONE for the children of the tree. */
+	TArray<int32> ParentIndices;
+
+	/** Where the objects are captured into, valid while the save is in progress. */
+	TSharedPtr<FPackedTreeRecordWriter> Writer;
+
+	/** The next object to capture in order. */
+	int32 Cursor = 0;
+
+	/** CRC of the data of each object when the save has begun, to check the captures against. Only outside of shipping builds, @see BeginIncrementalSave */
+	TArray<uint32> BeginDataCrcs;
+
+	float BudgetSeconds = 0.0f;
+
+	FOnGameObjectTreeSaved OnSaved;
+
+	FORCEINLINE bool IsActive() const { return Writer.IsValid(); }
+};
+
+/** A child of an object tree that has been left in the record it has been loaded from, @see UGameObjectTree::LoadFromRecord */
+struct FGameObjectDeferredSubtree
+{
+	/** Index of its block in the packed record. */
+	int32 BlockIndex = INDEX_NONE;
+
+	FName Name;
+	FName ID;
+
+	/** Class of the child, null if it can not be resolved. */
+	UClass* Class = nullptr;
+
+	/** The distinct classes and the IDs of its descendants, taken when the record is opened so lookups do not read the record. */
+	TArray<UClass*> DescendantClasses;
+	TSet<FName> DescendantIDs;
+};
+
 /**
 * Game Object Tree.
 * A special Game Object that can not have a parent and have saving and loading function to save and restore the object tree.
@@ -22,8 +164,112 @@ public:
 	virtual UGameObjectContainer* GetParent() const override final { return nullptr; }
 	virtual bool SetParent( UGameObjectContainer* InParent ) override final { return false; }
 	virtual UGameObjectTree* GetObjectTree() const override final { return (UGameObjectTree*) this; }
+	virtual void Tick( float DeltaTime ) override;
+	virtual void SimulationTick( const FTimespan& Timespan ) override;
+	virtual SIZE_T GetResourceSize( EResourceSizeMode::Type Mode ) override;
 	// End of UGameObjectContainer interface
 
+	/** Get the number of objects that are registered for world tick. */
+	int32 GetNumWorldTickObjects() const { return WorldTickList.Objects.Num() - WorldTickList.NumRemoved; }
+
+	/** Get the number of objects that are registered for simulation tick. */
+	int32 GetNumSimulationTickObjects() const { return SimulationTickList.Objects.Num() - SimulationTickList.NumRemoved; }
+
+	/**
+	* Whether to number the objects in depth first order so that ancestor checks are two integer comparisons.
+	* The numbering is redone by the first query after the tree has changed, so a burst of changes costs one renumbering.
+	* Queries from other threads walk up the parents while the numbering is out of date.
+	*/
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="GameObjectTree")
+	bool bUseIntervalNumbering = false;
+
+	/** Whether the interval numbering can be used for ancestor checks, renumbering first if it is out of date. */
+	bool HasValidIntervalNumbering() const;
+
+	/** Mark the interval numbering as out of date, it is redone by the next query. */
+	FORCEINLINE void InvalidateIntervalNumbering() { bIsIntervalNumberingValid = false; }
+
+	/** Number the objects in depth first order, @see bUseIntervalNumbering */
+	void RenumberIntervals();
+
+	/**
+	* Find the objects in this tree that are of a class, using the class index so the cost depends on the number of objects of the class, 
+	* not on the size of the tree. The objects of the class outside of the ancestor are filtered out, so finding the descendants of an ancestor
+	* costs the number of objects of the class in the whole tree, or the size of the ancestor's subtree when it is smaller and the interval
+	* numbering is valid. The objects are in depth first order, sorted by their interval numbers when the numbering is valid.
+	* @param InClass		Class of the objects.
+	* @param InAncestor		Only find the descendants of this container, nullptr or this tree to find in the whole tree.
+	* @param InTag			Only find the objects with this tag, empty to ignore tags.
+	* @param[out] OutObjects	The found objects.
+	* @return the number of objects found.
+	*/
+	int32 FindObjectsByClass( UClass* InClass, const UGameObjectContainer* InAncestor, const FString& InTag, TArray<UGameObject*>& OutObjects ) const;
+
+	/**
+	* Find an object in this tree that is of a class, the one a recursive FindChild of the ancestor would find: a child of the ancestor,
+	* otherwise the first descendant in depth first order. Each match is compared in constant time when the interval numbering is valid, @see FindObjectsByClass
+	*/
+	UGameObject* FindObjectByClass( UClass* InClass, const UGameObjectContainer* InAncestor, const FString& InTag ) const;
+
+	/** Rebuild the class index of every object tree, the objects of a reinstanced Blueprint class are new objects of a new class. */
+	static void RebuildAllClassIndices();
+
+	/** Get the total simulation time this tree has been ticked with. */
+	FORCEINLINE const FTimespan& GetSimulationTime() const { return SimulationTime; }
+
+	/**
+	* Whether the calling thread is simulating a thread safe subtree, on a worker or on the game thread helping the workers.
+	* Blueprint is never called from a thread safe subtree, whichever thread it ends up on.
+	*/
+	static bool IsSimulatingThreadSafeSubtree();
+
+	/** Get the number of thread safe subtrees that are simulated in parallel. */
+	int32 GetNumParallelSimulationRoots() const { return ParallelSimulationRootList.Objects.Num() - ParallelSimulationRootList.NumRemoved; }
+
+	/**
+	* Whether the thread safe subtrees are simulated after the other objects instead of before them.
+	* When false, the thread safe subtrees are simulated first, the game thread helps the workers, and the other objects are simulated once they are all done.
+	* When true, the thread safe subtrees are only simulated after all the other objects are done, so they see what the other objects did in the same tick.
+	* Either way the other objects never run while the thread safe subtrees are simulated, so they can change the tree, and the result does not depend
+	* on how the subtrees are scheduled: each subtree tracks its changes on its own and they are merged in the order the subtrees have been registered.
+	*/
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Simulation")
+	bool bSimulateThreadSafeSubtreesLast = false;
+
+	/** Maximum number of objects kept in the pool of each poolable class, the objects returned to a full pool are destroyed. Zero or less means no limit. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Pool")
+	int32 MaxPooledObjectsPerClass = 256;
+
+	/**
+	* Fill the pool of a poolable class up to a number of objects, so that many objects can be created later without allocating.
+	* @param	InClass		The poolable class.
+	* @param	InCount		Number of objects the pool should hold.
+	* @return the number of objects in the pool.
+	*/
+	UFUNCTION(BlueprintCallable, Category="Pool")
+	int32 PrewarmPool( TSubclassOf<UGameObject> InClass, int32 InCount );
+
+	/** Destroy all the pooled objects. */
+	UFUNCTION(BlueprintCallable, Category="Pool")
+	void EmptyPools();
+
+	/** Get the number of objects waiting in the pool of a class. */
+	UFUNCTION(BlueprintPure, Category="Pool")
+	int32 GetNumPooledObjects( TSubclassOf<UGameObject> InClass ) const;
+
+	/**
+	* Get the highest number of objects of a class that were in use at the same time, a good number to prewarm with.
+	* Every poolable object handed out by the pool or in this tree counts, including the prewarmed and the loaded ones.
+	*/
+	UFUNCTION(BlueprintPure, Category="Pool")
+	int32 GetPoolHighWaterMark( TSubclassOf<UGameObject> InClass ) const;
+
+	/** Reuse a pooled object of a class, or create a new one if the pool is empty. */
+	UGameObject* CreatePooledObject( UClass* InClass );
+
+	/** Get all objects that are waiting in the pools. */
+	void GetPooledObjects( TArray<UGameObject*>& OutObjects ) const;
+
 	UFUNCTION(BlueprintPure, Category="GameObjectTree")
 	UGameObjectContainer* GetOrCreateContainerForObject( TSubclassOf<UGameObject> InClass );
 	
@@ -42,6 +288,13 @@ public:
 		return pObject;
 	}
 
+	/**
+	* Whether to save into the packed format, which writes every class path and name once and the object data as a single blob.
+	* Records in either format can be loaded regardless of this setting.
+	*/
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="GameObjectTree")
+	bool bPackRecords = true;
+
 	/**
 	 * Load this GameObjectTree from a record.
 	 * @param InRecord	Record where this object tree will be loaded from.
@@ -49,11 +302,341 @@ public:
 	 */
 	bool LoadFromRecord( const FGameObjectTreeRecord& InRecord );
 
+	/**
+	* Load this GameObjectTree from a record, creating only some of the children of this tree together with their descendants.
+	* The other children stay in the record, each one is loaded with its descendants when it is looked for with FindChild, FindChildren or LoadDeferredSubtree.
+	* Until then they are not in the tree, so they are not ticked nor visited, but they are saved with the tree.
+	* FindChild can only match the tag after loading, a lookup by tag alone loads them all. Lookups off the game thread do not load anything.
+	* Only packed records can be loaded partially, other records are loaded whole.
+	* @param InRecord		Record where this object tree will be loaded from.
+	* @param InSubtreeIDs	IDs of the children of this tree to load right away.
+	* @return false if there's an error while loading the tree.
+	*/
+	bool LoadFromRecord( const FGameObjectTreeRecord& InRecord, const TArray<FName>& InSubtreeIDs );
+
+	/**
+	* Load a child of this tree that has been left in the record by LoadFromRecord, together with its descendants.
+	* @return the child with the ID, whether it has just been loaded or was already, null if there is none.
+	*/
+	UFUNCTION(BlueprintCallable, Category="GameObjectTree")
+	UGameObject* LoadDeferredSubtree( FName InID );
+
+	/** Load all the children of this tree that have been left in the record by LoadFromRecord. */
+	UFUNCTION(BlueprintCallable, Category="GameObjectTree")
+	void LoadAllDeferredSubtrees();
+
+	/** Get the number of children of this tree that have been left in the record by LoadFromRecord and are not loaded yet. */
+	UFUNCTION(BlueprintPure, Category="GameObjectTree")
+	int32 GetNumDeferredSubtrees() const;
+
+	/**
+	* Discard a child of this tree that has been left in the record by LoadFromRecord, together with its descendants, without loading it.
+	* @return false if there is no deferred child with the ID.
+	*/
+	UFUNCTION(BlueprintCallable, Category="GameObjectTree")
+	bool RemoveDeferredSubtree( FName InID );
+
+	/** Whether the child of this tree with an ID has been left in the record by LoadFromRecord and is not loaded yet. */
+	bool IsSubtreeDeferred( const FName& InID ) const;
+
 	/**
 	 * Save this GameObjectTree to a record. 
 	 * @param OutRecord		Record where this object tree will be saved into.
 	 * @return false if there's an error while saving the tree.
 	 */
 	bool SaveToRecord( FGameObjectTreeRecord& OutRecord ) const;
+
+	/**
+	* Begin saving this tree into a packed record over several ticks, capturing the objects in depth first order within a time budget per tick.
+	* The record is a snapshot of the moment the save begins: an object that is about to tick, or to leave this tree, before its turn is captured right away.
+	* Code that changes an object outside of the object's own tick while the save is in progress should call CaptureForSave first,
+	* the SaveGame property setters do. Setting a property directly from elsewhere makes the record mix the object before and after the change,
+	* set GameObjects.VerifyIncrementalSave to 1 to have such objects reported, outside of shipping builds.
+	* @param BudgetSeconds	Time to spend capturing objects per tick, zero or less to capture all of them on the next tick.
+	* @param OnSaved		Called once the save is done, or has been cancelled.
+	* @return false if another save is already in progress.
+	*/
+	bool BeginIncrementalSave( float BudgetSeconds, const FOnGameObjectTreeSaved& OnSaved );
+
+	/** Whether an incremental save is in progress. */
+	FORCEINLINE bool IsSaving() const { return SaveCapture.IsActive(); }
+
+	/** Capture all the objects that are left and complete the incremental save in progress right away. */
+	void FinishIncrementalSave();
+
+	/** Cancel the incremental save in progress, its delegate is called with a failure. */
+	void CancelIncrementalSave();
+
+	/**
+	* Maximum number of deltas a record can have, the deltas are merged into the packed data once there are more.
+	* Merging keeps loading fast and the record small, at the cost of rewriting the whole packed data. Less than zero means no limit.
+	*/
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="GameObjectTree")
+	int32 MaxSaveDeltas = 8;
+
+	/**
+	* Save only what has changed since the previous save into a record, as a delta on top of its packed data.
+	* The objects that have been added, removed, moved or marked with MarkSaveDirty are recorded, the others are not visited at all.
+	* A full packed save is done instead when the record is not the one this tree has been tracking changes against,
+	* e.g. the first time or after the record has been saved by SaveToRecord.
+	* @param InOutRecord	The record of the previous delta save, or of the load, of this tree.
+	* @return false if there's an error while saving the tree.
+	*/
+	bool SaveDeltaToRecord( FGameObjectTreeRecord& InOutRecord );
+
+	/** Get the number of objects that have changed since the previous delta save. */
+	FORCEINLINE int32 GetNumSaveDirtyObjects() const { return SaveDirtyObjects.Num(); }
+
+	/** Capture an object before it is changed, if the incremental save in progress has not captured it yet. */
+	FORCEINLINE void CaptureForSave( UGameObject* Object )
+	{
+		if ( Object->SaveCaptureIndex != INDEX_NONE )
+		{
+			CaptureForSave_Internal( Object );
+		}
+	}
+
+protected:
+
+	/** Called once after an object has been added to this tree together with its descendants. */
+	virtual void OnSubtreeAdded( UGameObject* Root );
+
+	/** Called once after an object has been removed from this tree together with its descendants. */
+	virtual void OnSubtreeRemoved( UGameObject* Root );
+
+	/** Event triggered once after an object has been added to this tree together with its descendants. */
+	UFUNCTION(BlueprintImplementableEvent, Category="GameObjectTree|Event", meta=(DisplayName="OnSubtreeAdded"))
+	void ReceiveSubtreeAdded( UGameObject* Root );
+
+	/** Event triggered once after an object has been removed from this tree together with its descendants. */
+	UFUNCTION(BlueprintImplementableEvent, Category="GameObjectTree|Event", meta=(DisplayName="OnSubtreeRemoved"))
+	void ReceiveSubtreeRemoved( UGameObject* Root );
+
+	// UGameObject protected interface
+	virtual void OnDispose() override;
+	// End of UGameObject protected interface
+
+private:
+
+	friend class UGameObject;
+	friend class UGameObjectContainer;
+
+	/** Objects that receive world tick, in the order they are ticked. */
+	UPROPERTY(Transient)
+	FGameObjectTickList WorldTickList;
+
+	/** Objects that receive simulation tick, in the order they are ticked. */
+	UPROPERTY(Transient)
+	FGameObjectTickList SimulationTickList;
+
+	/** Topmost thread safe objects that receive simulation tick, each one is simulated together with its subtree on a worker thread. */
+	UPROPERTY(Transient)
+	FGameObjectTickList ParallelSimulationRootList;
+
+	/** Objects that receive simulation tick once per interval, one bucket per interval. */
+	UPROPERTY(Transient)
+	TArray<FGameObjectTickBucket> TickBuckets;
+
+	/** Total simulation time this tree has been ticked with. */
+	FTimespan SimulationTime;
+
+	bool bIsIntervalNumberingValid = false;
+
+	/** 
+	* The objects in this tree by their exact class. 
+	* Not a property, the objects are referenced by their parents and are removed from here when they leave this tree.
+	*/
+	TMap<UClass*, TArray<UGameObject*>> ObjectsByClass;
+
+	void AddToClassIndex( UGameObject* Object );
+
+	void RemoveFromClassIndex( UGameObject* Object );
+
+	void ResetClassIndex();
+
+	/** Rebuild the class index from the objects in this tree. */
+	void RebuildClassIndex();
+
+	/** Whether an object comes before another one in depth first order, for when the interval numbering is not valid. */
+	static bool IsBeforeInPreOrder( const UGameObject* A, const UGameObject* B );
+
+	/** Call a function on every indexed object that matches, until it returns false. */
+	template<typename FuncType>
+	void ForEachObjectOfClass( UClass* InClass, const UGameObjectContainer* InAncestor, const FString& InTag, const FuncType& Func ) const;
+
+	/** Pools of disposed poolable objects, one per class. */
+	UPROPERTY(Transient)
+	TArray<FGameObjectPool> Pools;
+
+	TMap<UClass*, int32> PoolIndicesByClass;
+
+	FGameObjectPool* FindPool( UClass* InClass );
+
+	const FGameObjectPool* FindPool( UClass* InClass ) const;
+
+	FGameObjectPool& FindOrAddPool( UClass* InClass );
+
+	/** Put a disposed poolable object into its pool, returns false if the pool is full. */
+	bool ReturnToPool( UGameObject* Object );
+
+	/** Count a poolable object as active in the pool of its class, it stops being counted by the tree that counted it before. */
+	void CountActivePooledObject( UGameObject* Object );
+
+	/** Stop counting a poolable object as active in the pool of the tree that counts it. */
+	static void UncountActivePooledObject( UGameObject* Object );
+
+	/** Number an object and its descendants starting from a number, returns the next number. */
+	static int32 RenumberIntervals_Recursive( UGameObject* Object, int32 NextNumber );
+
+	/** How deep the tick lists are currently being iterated, the lists are only compacted when they are not being iterated. */
+	int32 TickListIterationDepth;
+
+	/** Notify an object that has just been attached to this tree, its descendants that want it and this tree. */
+	void NotifySubtreeAdded( UGameObject* Root );
+
+	/** Notify an object that has just been detached from this tree, its descendants that want it and this tree. */
+	void NotifySubtreeRemoved( UGameObject* Root );
+
+	/** Register an object that has just been attached to this tree and all of its descendants to the tick lists. */
+	void RegisterSubtree( UGameObject* Root );
+
+	/** Unregister an object that is about to be detached from this tree and all of its descendants from the tick lists. */
+	void UnregisterSubtree( UGameObject* Root );
+
+	void UnregisterSubtree_Recursive( UGameObject* Object );
+
+	/** Re-evaluate the tick registration of an object and its descendants after one of its tick flags has changed. */
+	void RefreshTickRegistration( UGameObject* Object );
+
+	/** Rebuild the tick lists from scratch. */
+	void RebuildTickLists();
+
+	void RegisterSubtree_Recursive( UGameObject* Object, bool bParentAllowsTick, bool bParentAllowsSimulationTick, bool bInParallelSimulationRoot );
+
+	/** Add an object to the simulation tick list, the parallel simulation roots or a tick bucket. */
+	void AddSimulationTicker( UGameObject* Object );
+
+	/** Remove an object from whichever simulation tick list it is in. */
+	void RemoveSimulationTicker( UGameObject* Object );
+
+	static bool IsRegisteredForSimulationTick( const UGameObject* Object );
+
+	void CompactSimulationTickLists();
+
+	void ResetSimulationTickLists();
+
+	/** Advance the tick buckets and collect the objects whose turn has come, with the simulation time they have missed. */
+	void CollectDueSimulationTicks( const FTimespan& Timespan, TArray<FGameObjectSimulationTick>& OutSerialTicks, TArray<FGameObjectSimulationTick>& OutParallelTicks );
+
+	/** Simulation tick the objects that are registered to the simulation tick list and the due ticks that are not thread safe, on the game thread. */
+	void SimulationTickSerial( const FTimespan& Timespan, const TArray<FGameObjectSimulationTick>& DueTicks );
+
+	/** Simulation tick an object and its descendants that can do simulation tick. */
+	static void SimulationTickSubtree( UGameObject* Object, const FTimespan& Timespan );
+
+	/** Simulation tick a thread safe subtree, flagging the calling thread for the duration, @see IsSimulatingThreadSafeSubtree */
+	static void SimulationTickThreadSafeSubtree( FGameObjectSimulationTick& ParallelTick );
+
+	/** Save this tree into the packed format, @see bPackRecords */
+	void SaveToPackedRecord( TArray<uint8>& OutPackedData ) const;
+
+	bool LoadFromRecord_Internal( const FGameObjectTreeRecord& InRecord, const TArray<FName>* InSubtreeIDs );
+
+	/** Load this tree from a record in the packed format, only the children with the IDs if they are specified. */
+	bool LoadFromPackedRecord( const TArray<uint8>& InPackedData, const TArray<FName>* InSubtreeIDs );
+
+	/**
+	* Create the objects of some blocks of a packed record, the top level objects become children of this tree.
+	* The objects are not registered to the tick lists.
+	* @param[out] OutObjects	The created objects.
+	* @return false if an object fails to load.
+	*/
+	bool LoadPackedBlocks( const FPackedTreeRecordReader& Reader, const TArray<int32>& BlockIndices, TArray<UGameObject*>& OutObjects );
+
+	/** The packed record the deferred children are loaded from, kept while there are any. */
+	TSharedPtr<FGameObjectDeferredRecord> DeferredRecord;
+
+	/** The children of this tree that have not been loaded yet, in their saved order. */
+	TArray<FGameObjectDeferredSubtree> DeferredSubtrees;
+
+	/** Index of each deferred child that has an ID in DeferredSubtrees, so lookups by ID do not scan them. */
+	TMap<FName, int32> DeferredSubtreeIndicesByID;
+
+	/** Rebuild the index of the deferred children by ID after some of them have been taken out. */
+	void RebuildDeferredSubtreeIndices();
+
+	/**
+	* Load the deferred children that match a lookup of the children of this tree, the tag can not be matched before loading
+	* so a lookup by tag alone, or by a class all of them are of, loads them all.
+	* A recursive lookup also loads the children that have a descendant of the class and a descendant with the ID.
+	* Lookups off the game thread, or from thread safe subtrees, can not create objects and only see the loaded children.
+	* @return the number of children loaded.
+	*/
+	int32 LoadDeferredSubtrees( UClass* InClass, const FName& InID, bool bRecursive );
+
+	/** Add the deferred children and their descendants to a packed record, as they have been loaded. */
+	void PackDeferredSubtrees( FPackedTreeRecordWriter& Writer ) const;
+
+	/**
+	* Move the generated names of the classes past the names of the deferred objects, so new objects do not take them before they are loaded.
+	* A deferred object whose name is taken anyway is loaded under another name, @see UGameObject::SaveName
+	*/
+	void ReserveDeferredNames( const FPackedTreeRecordReader& Reader ) const;
+
+	/** Forget the deferred children and release their record. */
+	void ResetDeferredSubtrees();
+
+	/** Add an object and its descendants to a packed record. */
+	static void PackSubtree_Recursive( FPackedTreeRecordWriter& Writer, UGameObject* Object, int32 ParentIndex );
+
+	/** The incremental save in progress. */
+	UPROPERTY(Transient)
+	FGameObjectSaveCapture SaveCapture;
+
+	/** Add an object and its descendants to the objects the incremental save has to capture. */
+	void CollectSaveCapture_Recursive( UGameObject* Object, int32 ParentIndex );
+
+	/** Capture objects in order until the time budget of this tick is spent. */
+	void ContinueIncrementalSave();
+
+	/** Capture an object that is waiting to be captured. */
+	void CaptureForSave_Internal( UGameObject* Object );
+
+	/** Capture an object and its descendants that are waiting to be captured, before they are simulated off the game thread. */
+	void CaptureSubtreeForSave( UGameObject* Object );
+
+	/** End the incremental save and call its delegate. */
+	void CompleteIncrementalSave( bool bSuccess );
+
+	/** Identifies the record the changes are tracked against, changes are only tracked while it is valid. */
+	FGuid SaveBaseID;
+
+	/** Objects that have changed since the previous delta save, an object may be listed after it has left this tree. */
+	UPROPERTY(Transient)
+	TArray<UGameObject*> SaveDirtyObjects;
+
+	/** Names of the objects that have left this tree since the previous delta save. */
+	TSet<FName> SaveRemovedNames;
+
+	/** Whether the children of this tree have changed since the previous delta save. */
+	bool bSaveChildrenDirty = false;
+
+	/** Track an object that has changed, or has been added to this tree. */
+	void NoteSaveDirty( UGameObject* Object );
+
+	/** Track an object that has left this tree. */
+	void NoteSaveRemoved( UGameObject* Object );
+
+	/** Track a container of this tree, or this tree itself, whose children have changed. */
+	void NoteSaveChildrenChanged( UGameObjectContainer* Container );
+
+	/** Forget the tracked changes and start tracking against another record, an invalid ID stops tracking. */
+	void ResetSaveDirtyState( const FGuid& BaseID );
+
+	/** Do a full packed save that the next deltas are saved against. */
+	bool SaveBaseToRecord( FGameObjectTreeRecord& OutRecord );
+
+	/** Get the names of the children of a container in slot order, as they are saved. */
+	static void GetSaveChildNames( const UGameObjectContainer* Container, TArray<FName>& OutNames );
 			
 };
\ No newline at end of file
@@ -1,6 +1,7 @@
 // @Author Fathurahman <ipat.bogor@gmail.com> @ipatizer
 #pragma once
 
+#include "Util/GameTagSet.h"
 #include "ObjectWithTags.generated.h"
 
 /** Object that has tags.
@@ -51,9 +52,40 @@ public:
 	UFUNCTION(BlueprintCallable, Category="Tag")
 	void RemoveTag( UPARAM(Ref) const FString& InTag );
 
+	/** Check if this object has a tag by its index in the global tag table, @see FGameTagTable */
+	FORCEINLINE bool HasTag( int32 InTagIndex ) const { return TagSet.Contains( InTagIndex ); }
+
+	/** Check if this object has any of the tags of a set. */
+	FORCEINLINE bool HasAnyTags( const FGameTagSet& InTagSet ) const { return TagSet.ContainsAny( InTagSet ); }
+
+	/** Check if this object has all of the tags of a set. */
+	FORCEINLINE bool HasAllTags( const FGameTagSet& InTagSet ) const { return TagSet.ContainsAll( InTagSet ); }
+
+	/** Get the tags of this object as a set of interned tags. */
+	FORCEINLINE const FGameTagSet& GetTagSet() const { return TagSet; }
+
+	/** Get the number of bytes allocated for the tags of this object. */
+	SIZE_T GetTagsAllocatedSize() const;
+
+	// UObject interface
+	virtual void PostInitProperties() override;
+	virtual void Serialize( FArchive& Ar ) override;
+	virtual SIZE_T GetResourceSize( EResourceSizeMode::Type Mode ) override;
+#if WITH_EDITOR
+	virtual void PostEditChangeProperty( FPropertyChangedEvent& PropertyChangedEvent ) override;
+#endif
+	// End of UObject interface
+
 protected:
 
+	/** The tags as they are authored, TagSet is what is used to match them. */
 	UPROPERTY(EditAnywhere, Category="Tag")
 	TArray<FString> Tags;
+
+	/** The tags interned into the global tag table. */
+	FGameTagSet TagSet;
+
+	/** Rebuild TagSet from Tags. */
+	void RebuildTagSet();
 	
 };
\ No newline at end of file
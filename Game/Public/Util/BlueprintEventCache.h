@@ -0,0 +1,48 @@
+// @Author Fathurahman <ipat.bogor@gmail.com> @ipatizer
+#pragma once
+
+/**
+* Remembers which BlueprintImplementableEvents of a native class are implemented by each class derived from it,
+* so native code can skip the events that have no implementation instead of paying for a ProcessEvent that does nothing.
+* A class is inspected the first time it is asked for, all caches are cleared when a Blueprint is compiled.
+* Only use it from the game thread.
+*/
+class GAME_API FBlueprintEventCache
+{
+public:
+
+	/** 
+	* Constructor, it only keeps the names so the cache can be a static variable.
+	* @param	InEventNames	Names of the event functions, the index of an event is its position in the list, at most 32 events.
+	*/
+	FBlueprintEventCache( std::initializer_list<const TCHAR*> InEventNames );
+
+	/** Whether the class of an object implements an event. */
+	FORCEINLINE bool IsImplemented( const UObject* Object, int32 EventIndex ) const
+	{
+		return ( GetImplementedEvents( Object->GetClass() ) & ( 1u << EventIndex ) ) != 0;
+	}
+
+	/** Get a mask with the bit of every event a class implements. */
+	uint32 GetImplementedEvents( const UClass* Class ) const;
+
+	/** Forget what every cache knows, the classes are inspected again the next time they are asked for. */
+	static void InvalidateAll();
+
+private:
+
+	TArray<const TCHAR*> EventNames;
+
+	mutable TMap<const UClass*, uint32> ImplementedEventsByClass;
+
+	/** The class that was asked for last, most calls ask for the same class as the previous one. */
+	mutable const UClass* LastClass;
+
+	mutable uint32 LastImplementedEvents;
+
+	/** The value of Generation when this cache was last cleared. */
+	mutable int32 CachedGeneration;
+
+	/** Incremented by InvalidateAll. */
+	static int32 Generation;
+};
@@ -0,0 +1,69 @@
+// @Author Fathurahman <ipat.bogor@gmail.com> @ipatizer
+#pragma once
+
+#include "GameTypes.h"
+
+/** Versions of the chunked compression format. */
+namespace EChunkedCompressionVersion
+{
+	enum Type
+	{
+		Initial = 1,
+
+		// -----<new versions can be added above this line>-----
+		VersionPlusOne,
+		Latest = VersionPlusOne - 1
+	};
+}
+
+/**
+* Header at the start of a chunked compressed buffer.
+* Layout: header, compressed size of each chunk, chunks. A chunk whose compressed size equals its uncompressed size is stored as is.
+*/
+struct FChunkedCompressionHeader
+{
+	enum { ChunkedMagic = 0x4B484347 };
+
+	uint32 Magic = ChunkedMagic;
+	int32 Version = EChunkedCompressionVersion::Latest;
+	ESaveGameCompression Codec = ESaveGameCompression::None;
+	int32 ChunkSize = 0;
+	int64 UncompressedSize = 0;
+	int32 NumChunks = 0;
+
+	friend FArchive& operator<<( FArchive& Ar, FChunkedCompressionHeader& Header );
+};
+
+/**
+* Compresses big buffers in fixed size chunks that are compressed and decompressed in parallel on worker threads.
+* Safe to use from any thread.
+*/
+class GAME_API FChunkedCompression
+{
+public:
+
+	/** Uncompressed size of a chunk, small enough to spread a save game over all the workers and big enough to compress well. */
+	static const int32 DefaultChunkSize = 256 * 1024;
+
+	/**
+	* Compress a buffer.
+	* @param	Codec		The codec to compress the chunks with, None only splits the buffer into chunks.
+	* @param	Data		The buffer to compress.
+	* @param	Size		Size of the buffer.
+	* @param	OutBytes	The header, the chunk table and the chunks.
+	* @param	ChunkSize	Uncompressed size of the chunks.
+	*/
+	static void Compress( ESaveGameCompression Codec, const uint8* Data, int64 Size, TArray<uint8>& OutBytes, int32 ChunkSize = DefaultChunkSize );
+
+	/**
+	* Decompress a buffer written by Compress.
+	* @param	Data		The compressed buffer.
+	* @param	Size		Size of the compressed buffer.
+	* @param	OutBytes	The uncompressed buffer.
+	* @return false if the buffer is corrupt.
+	*/
+	static bool Decompress( const uint8* Data, int64 Size, TArray<uint8>& OutBytes );
+
+	/** Get the flags FCompression compresses with for a codec. */
+	static ECompressionFlags GetCompressionFlags( ESaveGameCompression Codec );
+};
@@ -0,0 +1,55 @@
+// @Author Fathurahman <ipat.bogor@gmail.com> @ipatizer
+#pragma once
+
+#include "Commandlets/Commandlet.h"
+#include "Object/GameObject.h"
+#include "GameObjectBenchmarkCommandlet.generated.h"
+
+/** A game object that ticks without doing anything, the benchmarks fill the trees with it. */
+UCLASS(Transient, NotBlueprintable)
+class GAME_API UGameObjectBenchmarkObject : public UGameObject
+{
+	GENERATED_BODY()
+public:
+
+	UGameObjectBenchmarkObject( const FObjectInitializer& ObjectInitializer );
+
+	int32 NumTicks = 0;
+
+	int32 NumSimulationTicks = 0;
+
+	// UGameObject interface
+	virtual void Tick( float DeltaTime ) override;
+	virtual void SimulationTick( const FTimespan& Timespan ) override;
+	// End of UGameObject interface
+};
+
+/** The object the find benchmarks look for, there is one at the end of every container. */
+UCLASS(Transient, NotBlueprintable)
+class GAME_API UGameObjectBenchmarkTarget : public UGameObjectBenchmarkObject
+{
+	GENERATED_BODY()
+public:
+
+	UGameObjectBenchmarkTarget( const FObjectInitializer& ObjectInitializer );
+};
+
+/**
+* Measures the core operations of game object containers and trees at several tree sizes, headless.
+* Usage: -run=GameObjectBenchmark [-Sizes=1000,10000,100000,1000000] [-Iterations=100] [-Output=<path without extension>]
+*                                 [-Baseline=<csv of a previous run>] [-MaxRegression=0.25]
+* Writes the time and number of allocations per operation, and the sizes of the records and compressed saves, to <Output>.csv and <Output>.json.
+* Returns 1 if a result is slower, allocates more or is larger than its baseline by more than MaxRegression.
+*/
+UCLASS()
+class GAME_API UGameObjectBenchmarkCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+public:
+
+	UGameObjectBenchmarkCommandlet( const FObjectInitializer& ObjectInitializer );
+
+	// UCommandlet interface
+	virtual int32 Main( const FString& Params ) override;
+	// End of UCommandlet interface
+};
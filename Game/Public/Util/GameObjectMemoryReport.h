@@ -0,0 +1,59 @@
+// @Author Fathurahman <ipat.bogor@gmail.com> @ipatizer
+#pragma once
+
+class UGameObjectTree;
+
+/** Memory used by the objects of one class. */
+struct GAME_API FGameObjectClassMemory
+{
+	FString ClassName;
+
+	int32 NumObjects = 0;
+
+	/** Size of the objects themselves. */
+	int64 ShallowBytes = 0;
+
+	/** Size of the objects, the memory their properties and native members allocate, and their subobjects. */
+	int64 DeepBytes = 0;
+
+	/** Part of DeepBytes used by the tags. */
+	int64 TagBytes = 0;
+
+	/** Approximate size of the name table entries of the distinct IDs, IDs are names so they are shared and not part of DeepBytes. */
+	int64 IDBytes = 0;
+
+	/** Add the memory of another class to this one. */
+	void Accumulate( const FGameObjectClassMemory& Other, int32 Sign = 1 );
+};
+
+/**
+* Memory used by the objects of a game object tree, per class, including the objects in its pools.
+* Capturing a report visits every object, so it is meant for console commands and occasional sampling, not for every frame.
+* Console commands: GameObjects.MemReport prints a report of the current game, GameObjects.MemSnapshot keeps one,
+* GameObjects.MemDiff prints what has changed since the kept one.
+* The GameObjectMemory stat group shows the totals of the last captured report, set GameObjects.MemStatInterval to capture periodically.
+*/
+struct GAME_API FGameObjectMemoryReport
+{
+	FDateTime Time;
+
+	/** Per class memory, the classes that use the most memory first. */
+	TArray<FGameObjectClassMemory> Classes;
+
+	FGameObjectClassMemory Total;
+
+	/** Capture the memory used by a tree. */
+	static FGameObjectMemoryReport Capture( const UGameObjectTree* Tree );
+
+	/** Get the difference from an earlier report, classes that have not changed are left out. */
+	FGameObjectMemoryReport DiffFrom( const FGameObjectMemoryReport& Earlier ) const;
+
+	/** Print this report as a table. */
+	void Print( FOutputDevice& Ar ) const;
+
+	/** Set the GameObjectMemory stats to the totals of this report. */
+	void UpdateStats() const;
+
+	/** Capture a report of a tree to update the stats if GameObjects.MemStatInterval has passed since the last one. */
+	static void TickStats( const UGameObjectTree* Tree );
+};
@@ -0,0 +1,129 @@
+// @Author Fathurahman <ipat.bogor@gmail.com> @ipatizer
+#pragma once
+
+/**
+* Global table of interned tags.
+* Every tag is given a small index the first time it is interned, the index is the tag's bit in FGameTagSet.
+* Tags are compared the same way FString is compared, which is case insensitive. The table only grows and it is thread safe.
+* The tags are stored in chunks that never move and are chained in a fixed number of hash buckets, so lookups read them without locking.
+* Only interning a new tag locks, the tag is written before its bucket and the count are published.
+*/
+class GAME_API FGameTagTable
+{
+public:
+
+	FGameTagTable();
+	~FGameTagTable();
+
+	/** Get the global tag table. */
+	static FGameTagTable& Get();
+
+	/** Get the index of a tag, interning it first if it has never been interned. */
+	int32 Intern( const FString& InTag );
+
+	/** Get the index of a tag, INDEX_NONE if it has never been interned which means nothing has the tag. */
+	int32 Find( const FString& InTag ) const;
+
+	/** Get the tag at an index. */
+	FString GetTag( int32 InIndex ) const;
+
+	/** Get the number of interned tags. */
+	int32 Num() const;
+
+private:
+
+	struct FEntry
+	{
+		FString Tag;
+
+		/** Index of the next tag in the same bucket, INDEX_NONE for the last one. */
+		int32 NextInBucket;
+	};
+
+	enum
+	{
+		ChunkSize = 1024,
+		MaxChunks = 1024,
+		NumBuckets = 4096,
+	};
+
+	FORCEINLINE const FEntry& GetEntry( int32 Index ) const { return Chunks[Index / ChunkSize][Index % ChunkSize]; }
+
+	/** Serializes interning. */
+	FCriticalSection CriticalSection;
+
+	/** The tags by index, a chunk is allocated when the previous one is full. */
+	FEntry* Chunks[MaxChunks];
+
+	/** Index of the latest tag interned in each bucket, INDEX_NONE for an empty bucket. */
+	volatile int32 Buckets[NumBuckets];
+
+	volatile int32 NumTags;
+};
+
+	/** Get the latest published snapshot. */
+	FORCEINLINE const FSnapshot& GetSnapshot() const { return *Snapshot; }
+
+	/** Serializes interning. */
+	FCriticalSection CriticalSection;
+
+	/** The latest snapshot, replaced as a whole when a tag is interned. */
+	const FSnapshot* volatile Snapshot = new FSnapshot();
+
+	/** The snapshots that have been replaced. */
+	TArray<const FSnapshot*> RetiredSnapshots;
+};
+
+/**
+* A set of interned tags stored as a bitset, one bit per tag index.
+* Matching a set against another one is a word by word AND, most sets fit in the inline words so they do not allocate.
+*/
+struct GAME_API FGameTagSet
+{
+	/** Add a tag by its index. */
+	void Add( int32 InIndex );
+
+	/** Remove a tag by its index. */
+	void Remove( int32 InIndex );
+
+	/** Remove all tags. */
+	FORCEINLINE void Reset() { Words.Reset(); }
+
+	/** Check whether this set contains a tag by its index. */
+	FORCEINLINE bool Contains( int32 InIndex ) const
+	{
+		const int32 WordIndex = InIndex >> 6;
+		return InIndex >= 0 && WordIndex < Words.Num() && ( Words[WordIndex] & ( 1ULL << ( InIndex & 63 ) ) ) != 0;
+	}
+
+	/** Check whether this set contains any of the tags of another set, false if the other set is empty. */
+	bool ContainsAny( const FGameTagSet& Other ) const;
+
+	/** Check whether this set contains all of the tags of another set, true if the other set is empty. */
+	bool ContainsAll( const FGameTagSet& Other ) const;
+
+	/** Check whether this set contains no tag. */
+	bool IsEmpty() const;
+
+	/**
+	* Make a set from tags, interning them if necessary.
+	* @param	InTags	The tags.
+	* @return the set.
+	*/
+	static FGameTagSet Intern( const TArray<FString>& InTags );
+
+	/**
+	* Make a set for matching objects from tags without interning them.
+	* @param	InTags		The tags.
+	* @param[out] OutSet	The set of the tags that have been interned.
+	* @return false if some of the tags have never been interned, nothing can have all of the tags then.
+	*/
+	static bool Find( const TArray<FString>& InTags, FGameTagSet& OutSet );
+
+	/** Get the number of bytes allocated for the words that do not fit inline. */
+	FORCEINLINE uint32 GetAllocatedSize() const { return Words.Max() > 2 ? Words.GetAllocatedSize() : 0; }
+
+private:
+
+	TArray<uint64, TInlineAllocator<2>> Words;
+};
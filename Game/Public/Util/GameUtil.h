@@ -3,17 +3,25 @@
 #include "GameTypes.h"
 #include "CoreUtil.h"
 #include "AssetRegistryModule.h"
+#include "GameTagSet.h"
 
 template<class T=UObjectWithTags>
 void GetObjectsWithTag( const FString& InTag, TArray<T*>& OutResult, EObjectFlags FlagsToCheck = RF_NoFlags )
 {
 	OutResult.Empty();
+
+	const int32 TagIndex = FGameTagTable::Get().Find( InTag );
+	if ( TagIndex == INDEX_NONE )
+	{
+		return;
+	}
+
 	for (TObjectIterator<T> It; It; ++It)
 	{
 		T* Object = *It;
 		if ( FlagsToCheck == RF_NoFlags || Object->HasAllFlags( FlagsToCheck ) == true )
 		{
-			if (Object->HasTag( InTag ))
+			if (Object->HasTag( TagIndex ))
 			{
 				OutResult.Add( Object );
 			}
@@ -163,18 +171,23 @@ int32 GetRandomWeightedIndex(const TArray<T>& Array, FRandomStream* RandomStream
 	return INDEX_NONE;
 }
 
-GAME_API class UGameObject* StaticCreateGameObject( TSubclassOf<UGameObject> Class );
+/**
+* Create a game object in the transient package.
+* @param	Class		The object's class.
+* @param	PoolTree	If the class is poolable, reuse an object from the pool of this tree when there is one.
+*/
+GAME_API class UGameObject* StaticCreateGameObject( TSubclassOf<UGameObject> Class, class UGameObjectTree* PoolTree = nullptr );
 
 template<class T=UGameObject>
-FORCEINLINE T* CreateGameObject()
+FORCEINLINE T* CreateGameObject( class UGameObjectTree* PoolTree = nullptr )
 {
-	return Cast<T>( StaticCreateGameObject( T::StaticClass() ) );
+	return Cast<T>( StaticCreateGameObject( T::StaticClass(), PoolTree ) );
 }
 
 template<class T=UGameObject>
-FORCEINLINE T* CreateGameObject( TSubclassOf<T> Class )
+FORCEINLINE T* CreateGameObject( TSubclassOf<T> Class, class UGameObjectTree* PoolTree = nullptr )
 {
-	return Cast<T>( StaticCreateGameObject( Class ) );
+	return Cast<T>( StaticCreateGameObject( Class, PoolTree ) );
 }
 
 template<typename T=FNamedData, typename ValueType>
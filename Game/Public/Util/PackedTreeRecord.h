@@ -0,0 +1,275 @@
+// @Author Fathurahman <ipat.bogor@gmail.com> @ipatizer
+#pragma once
+
+#include "SaveGameLayout.h"
+
+class UGameObject;
+struct FGameObjectTreeDeltaRecord;
+
+/** Versions of the packed tree record format. */
+namespace EPackedTreeRecordVersion
+{
+	enum Type
+	{
+		Initial = 1,
+
+		/** The class table records the SaveGame layout of each class, the objects of a class with a layout are saved through it. */
+		SaveGameLayouts,
+
+		// -----<new versions can be added above this line>-----
+		VersionPlusOne,
+		Latest = VersionPlusOne - 1
+	};
+}
+
+/**
+* Header at the start of a packed tree record, the offsets are from the start of the record.
+* Layout: header, string table, class table, object entries, payload.
+* Each class is the string index of its path, followed by the hash and the properties of its SaveGame layout, zero hash for the tagged path.
+*/
+struct FPackedTreeRecordHeader
+{
+	enum { PackedMagic = 0x50544F47 };
+
+	uint32 Magic = PackedMagic;
+	int32 Version = EPackedTreeRecordVersion::Latest;
+
+	int32 NumStrings = 0;
+	int32 NumClasses = 0;
+	int32 NumObjects = 0;
+
+	int64 StringsOffset = 0;
+	int64 ClassesOffset = 0;
+	int64 ObjectsOffset = 0;
+	int64 PayloadOffset = 0;
+	int64 PayloadSize = 0;
+
+	/** The data of the tree itself, relative to the payload. */
+	int64 TreePayloadOffset = 0;
+	int64 TreePayloadSize = 0;
+
+	/** Size of the header as it is written. */
+	static const int64 PackedSize;
+
+	friend FArchive& operator<<( FArchive& Ar, FPackedTreeRecordHeader& Header );
+};
+
+/**
+* Fixed size entry of an object in a packed tree record.
+* The entries are in depth first order, so a parent comes before its children and the children of a parent are in their slot order.
+*/
+struct FPackedObjectEntry
+{
+	/** Index in the class table. */
+	int32 ClassIndex = INDEX_NONE;
+
+	/** Index of the object name in the string table. */
+	int32 NameIndex = INDEX_NONE;
+
+	/** Index of the object ID in the string table, INDEX_NONE if the object has no ID. */
+	int32 IDIndex = INDEX_NONE;
+
+	/** Index of the parent entry, INDEX_NONE if the parent is the tree. */
+	int32 ParentIndex = INDEX_NONE;
+
+	/** The serialized object, relative to the payload. */
+	int64 PayloadOffset = 0;
+	int64 PayloadSize = 0;
+
+	/** Size of an entry as it is written. */
+	static const int64 PackedSize;
+
+	friend FArchive& operator<<( FArchive& Ar, FPackedObjectEntry& Entry );
+};
+
+/** A top level object and its descendants, their entries are contiguous since the entries are in depth first order. */
+struct FPackedSubtreeBlock
+{
+	int32 FirstEntry = 0;
+	int32 NumEntries = 0;
+};
+
+/**
+* Writes a packed tree record: class paths, names and IDs are written once in the string table and referred to by index,
+* the objects are serialized one after another into a single payload.
+*/
+class GAME_API FPackedTreeRecordWriter
+{
+public:
+
+	FPackedTreeRecordWriter();
+
+	/**
+	* Serialize an object into the record, objects must be added in depth first order.
+	* @param	Object			The object to add.
+	* @param	ParentIndex		Index returned when the parent was added, INDEX_NONE if the parent is the tree.
+	* @return the index of the object entry.
+	*/
+	int32 AddObject( UGameObject* Object, int32 ParentIndex );
+
+	/** Make room for a number of objects, so they can be serialized in any order with SetObject. */
+	void SetNumObjects( int32 NumObjects );
+
+	/**
+	* Serialize an object into an entry made by SetNumObjects, every entry must be set before the record is finished.
+	* @param	Index			Index of the entry, in depth first order.
+	* @param	Object			The object to serialize.
+	* @param	ParentIndex		Index of the parent entry, INDEX_NONE if the parent is the tree.
+	*/
+	void SetObject( int32 Index, UGameObject* Object, int32 ParentIndex );
+
+	/** Get the number of entries made by SetNumObjects that have not been set yet. */
+	int32 GetNumUnsetObjects() const;
+
+	/** Get the CRC of the serialized data of an object entry that has been set. */
+	uint32 GetObjectDataCrc( int32 Index ) const;
+
+	/**
+	* Add an object that has already been serialized, objects must be added in depth first order.
+	* @param	ClassPath		Path name of the class of the object.
+	* @param	Layout			The layout the object has been serialized with, null if it has been serialized through the tagged path.
+	* @param	Name			Name of the object.
+	* @param	ID				ID of the object, None if it has no ID.
+	* @param	ParentIndex		Index returned when the parent was added, INDEX_NONE if the parent is the tree.
+	* @param	ObjectData		The serialized object.
+	* @param	ObjectDataSize	Size of the serialized object.
+	* @return the index of the object entry.
+	*/
+	int32 AddPackedObject( const FString& ClassPath, const FSaveGameLayoutDesc* Layout, const FName& Name, const FName& ID, int32 ParentIndex, const uint8* ObjectData, int64 ObjectDataSize );
+
+	/** Serialize the data of the tree itself into the record. */
+	void SetTreeData( UObject* Tree );
+
+	/** Set the data of the tree itself, already serialized. */
+	void SetTreeData( const uint8* TreeData, int64 TreeDataSize );
+
+	/** Write the whole record. */
+	void Finish( TArray<uint8>& OutBytes );
+
+	/** Add a string to the string table, @return its index. */
+	int32 AddString( const FString& String );
+
+	/** Add a name to the string table, @return its index. */
+	int32 AddName( const FName& Name );
+
+	/** Add a class to the class table with its SaveGame layout, unless its objects do not use one, @return its index. */
+	int32 AddClass( UClass* Class );
+
+	/** Add a class to the class table by its path name and the layout its objects are serialized with, @return its index. */
+	int32 AddClassPath( const FString& ClassPath, const FSaveGameLayoutDesc* Layout );
+
+	/**
+	* Merge deltas into a packed record, without creating any object so it can be done on any thread.
+	* The objects that are no longer reachable from the tree after the deltas are applied are dropped.
+	* @param	InBase		The packed record the deltas have been saved against.
+	* @param	InDeltas	The deltas, in the order they have been saved.
+	* @param	OutMerged	The packed record with the deltas applied.
+	* @return false if the base is corrupt.
+	*/
+	static bool MergeDeltas( const TArray<uint8>& InBase, const TArray<FGameObjectTreeDeltaRecord>& InDeltas, TArray<uint8>& OutMerged );
+
+private:
+
+	TArray<FString> Strings;
+	TMap<FString, int32> StringIndices;
+	TMap<FName, int32> NameIndices;
+
+	/** String indices of the class paths. */
+	TArray<int32> Classes;
+	TMap<UClass*, int32> ClassIndices;
+
+	/** The layout of each class, tagged for the classes whose objects are serialized through the tagged path. */
+	TArray<FSaveGameLayoutDesc> ClassLayouts;
+
+	/** The layout to save the objects of each class with, null for the tagged path or for the classes added by path. */
+	TArray<const FSaveGameLayout*> ClassSaveLayouts;
+
+	/** Class indices by the string index of their path and the hash of their layout. */
+	TMap<uint64, int32> ClassIndicesByPath;
+
+	TArray<FPackedObjectEntry> Entries;
+	TArray<uint8> Payload;
+
+	int64 TreePayloadOffset;
+	int64 TreePayloadSize;
+};
+
+/**
+* Reads a packed tree record in place, the memory of the record must be kept alive while the reader is used.
+* Opening a record validates all its offsets and indices up front, so the accessors do not need to check anything.
+*/
+class GAME_API FPackedTreeRecordReader
+{
+public:
+
+	FPackedTreeRecordReader();
+
+	/**
+	* Validate and open a record, resolving its classes.
+	* @param	bResolveClasses		Whether to resolve the classes, which can only be done on the game thread. GetClass can not be used when they are not.
+	* @return false if the record is corrupt, unresolved classes are not an error, their entries have a null class.
+	*/
+	bool Open( const uint8* InData, int64 InSize, bool bResolveClasses = true );
+
+	/** Check that a record is not corrupt without resolving its classes or reading the object data. */
+	static bool Validate( const uint8* InData, int64 InSize );
+
+	FORCEINLINE const FPackedTreeRecordHeader& GetHeader() const { return Header; }
+
+	FORCEINLINE int32 GetNumObjects() const { return Entries.Num(); }
+
+	FORCEINLINE const FPackedObjectEntry& GetEntry( int32 Index ) const { return Entries[Index]; }
+
+	/** Get the number of top level objects, each one can be loaded with its descendants independently of the others. */
+	FORCEINLINE int32 GetNumBlocks() const { return Blocks.Num(); }
+
+	FORCEINLINE const FPackedSubtreeBlock& GetBlock( int32 Index ) const { return Blocks[Index]; }
+
+	FORCEINLINE const FString& GetString( int32 Index ) const { return Strings[Index]; }
+
+	/** Get the class of an entry, null if it can not be resolved. */
+	FORCEINLINE UClass* GetClass( const FPackedObjectEntry& Entry ) const { return Classes[Entry.ClassIndex]; }
+
+	/** Get the path of the class of an entry. */
+	FORCEINLINE const FString& GetClassPath( const FPackedObjectEntry& Entry ) const { return Strings[ClassPathIndices[Entry.ClassIndex]]; }
+
+	FORCEINLINE FName GetName( const FPackedObjectEntry& Entry ) const { return FName( *Strings[Entry.NameIndex] ); }
+
+	FORCEINLINE FName GetID( const FPackedObjectEntry& Entry ) const { return Entry.IDIndex == INDEX_NONE ? NAME_None : FName( *Strings[Entry.IDIndex] ); }
+
+	/** Get the layout the objects of the class of an entry have been saved with. */
+	FORCEINLINE const FSaveGameLayoutDesc& GetClassLayout( const FPackedObjectEntry& Entry ) const { return ClassLayouts[Entry.ClassIndex]; }
+
+	/** Get the serialized data of an entry. */
+	FORCEINLINE const uint8* GetObjectData( const FPackedObjectEntry& Entry ) const { return Data + Header.PayloadOffset + Entry.PayloadOffset; }
+
+	/** Get the serialized data of the tree itself, its size is in the header. */
+	FORCEINLINE const uint8* GetTreeData() const { return Data + Header.PayloadOffset + Header.TreePayloadOffset; }
+
+	/** Deserialize an object from the data of an entry, @return false on a read error. */
+	bool SerializeObject( const FPackedObjectEntry& Entry, UObject* Object ) const;
+
+	/** Deserialize the tree itself, @return false on a read error. */
+	bool SerializeTree( UObject* Tree ) const;
+
+private:
+
+	/** Read and validate the header and tables. */
+	bool ReadTables( const uint8* InData, int64 InSize );
+
+	bool SerializePayload( int64 Offset, int64 PayloadSize, UObject* Object ) const;
+
+	const uint8* Data;
+	int64 Size;
+
+	FPackedTreeRecordHeader Header;
+	TArray<FString> Strings;
+	TArray<int32> ClassPathIndices;
+	TArray<FSaveGameLayoutDesc> ClassLayouts;
+	TArray<UClass*> Classes;
+
+	/** Properties matched by class index, for the classes whose layout has changed since the record has been saved. */
+	mutable TMap<int32, TArray<UProperty*>> MatchedProperties;
+	TArray<FPackedObjectEntry> Entries;
+	TArray<FPackedSubtreeBlock> Blocks;
+};
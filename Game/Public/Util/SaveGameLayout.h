@@ -0,0 +1,100 @@
+// @Author Fathurahman <ipat.bogor@gmail.com> @ipatizer
+#pragma once
+
+/** A SaveGame property as it is recorded with a layout, enough to find it again after its class has changed. */
+struct FSaveGamePropertyDesc
+{
+	FName Name;
+
+	/**
+	* Type of the property together with the types it contains, e.g. ArrayProperty<StructProperty<Transform>>.
+	* Plain old data structs also have the hash of the layout of their members, e.g. StructProperty<Vector:1A2B3C4D>.
+	*/
+	FName Type;
+
+	int32 ArrayDim = 1;
+
+	/** Size of the value when it is copied as is, zero when it is serialized behind its size. */
+	int32 Size = 0;
+};
+
+/** The SaveGame properties of a class in the order they are saved, and a hash that changes whenever any of them does. */
+struct FSaveGameLayoutDesc
+{
+	/** Zero for the objects that are saved through the tagged path. */
+	uint32 Hash = 0;
+
+	TArray<FSaveGamePropertyDesc> Properties;
+
+	FORCEINLINE bool IsTagged() const { return Hash == 0; }
+};
+
+/**
+* Precompiled layout of the SaveGame properties of a class, built once per class instead of filtering every property on every save.
+* The plain old data properties that are next to each other in memory are copied as a single block, the others are serialized
+* one by one behind their size, so no name or type is written per object. Records store the layout once per class next to the data,
+* data saved with a layout that no longer matches its class is loaded by matching the properties by name and type instead.
+* The blocks are copied as they are in memory: they are in the byte order of the platform that has saved them, without byte swapping,
+* and the padding inside plain old data structs is written with whatever it holds. Records saved with layouts are not meant to be loaded
+* on a platform of another byte order, nor compared byte for byte.
+*/
+class GAME_API FSaveGameLayout
+{
+public:
+
+	/** Get the layout of a class, it is built the first time and rebuilt after the class has been recompiled. Game thread only. */
+	static const FSaveGameLayout& Get( UClass* Class );
+
+	/** Forget all the layouts. */
+	static void Reset();
+
+	FORCEINLINE const FSaveGameLayoutDesc& GetDesc() const { return Desc; }
+
+	FORCEINLINE uint32 GetHash() const { return Desc.Hash; }
+
+	/** Save the SaveGame properties of an object of the class of this layout. */
+	void Save( UObject* Object, FArchive& Ar ) const;
+
+	/** Load the SaveGame properties of an object that have been saved with this layout, @return false on a read error. */
+	bool Load( UObject* Object, FArchive& Ar ) const;
+
+	/**
+	* Match the properties a layout has been saved with to the properties of this layout, by name, type and size.
+	* @param	SavedDesc		The layout the data has been saved with.
+	* @param	OutProperties	The property of this layout for each saved property, null for the ones that can not be matched.
+	*/
+	void MatchProperties( const FSaveGameLayoutDesc& SavedDesc, TArray<UProperty*>& OutProperties ) const;
+
+	/** Load the SaveGame properties of an object that have been saved with another layout, the properties that are not matched are skipped. */
+	static bool LoadMatched( UObject* Object, FArchive& Ar, const FSaveGameLayoutDesc& SavedDesc, const TArray<UProperty*>& Properties );
+
+private:
+
+	explicit FSaveGameLayout( UClass* InClass );
+
+	/** Whether this layout has been built from the class as it is now. */
+	bool IsUpToDate( UClass* InClass ) const;
+
+	/** Either a block of plain old data properties, or a single property that is serialized. */
+	struct FStep
+	{
+		int32 Offset;
+		int32 Size;
+
+		/** Null for a block. */
+		UProperty* Property;
+	};
+
+	TArray<FStep> Steps;
+
+	/** The properties in the order of their description. */
+	TArray<UProperty*> Properties;
+
+	FSaveGameLayoutDesc Desc;
+
+	TWeakObjectPtr<UClass> Class;
+
+	/** The properties of the class when this layout has been built, recompiling a class relinks them. */
+	UProperty* PropertyLink;
+	int32 PropertiesSize;
+};
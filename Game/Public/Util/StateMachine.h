@@ -25,11 +25,11 @@ public:
 
 	bool CanEnterFrom( UState* State ) const;
 
-	virtual void OnEnter() { ReceiveOnEnter(); }
+	virtual void OnEnter();
 
-	virtual void OnExit() { ReceiveOnExit(); }
+	virtual void OnExit();
 
-	virtual void OnEvent( const FString& EventName, UObject* Object ) { ReceiveEvent( EventName, Object ); }
+	virtual void OnEvent( const FString& EventName, UObject* Object );
 
 protected:
 
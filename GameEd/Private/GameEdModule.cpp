@@ -1,6 +1,8 @@
 // @Author Fathurahman <ipat.bogor@gmail.com> @ipatizer
 #include "GameEdPrivatePCH.h"
 #include "AssetToolsModule.h"
+#include "Util/BlueprintEventCache.h"
+#include "Object/GameObjectTree.h"
 
 DEFINE_LOG_CATEGORY( LogGameObjectEd )
 
@@ -13,12 +15,44 @@ class FGameObjectEd : public IGameObjectEd
 		FAssetToolsModule& AssetToolsModule = FModuleManager::LoadModuleChecked<FAssetToolsModule>("AssetTools");
 		IAssetTools& AssetTools = AssetToolsModule.Get();
 		GameAssetCategory = (uint32)AssetTools.RegisterAdvancedAssetCategory("Game", LOCTEXT("Game", "Game"));
+
+		// The editor does not exist yet when the module starts up, the first tick of the engine loop binds to it.
+		BindEditorTickerHandle = FTicker::GetCoreTicker().AddTicker( FTickerDelegate::CreateRaw( this, &FGameObjectEd::BindEditor ) );
 	}
 
 	virtual void ShutdownModule() override
 	{
-		
+		FTicker::GetCoreTicker().RemoveTicker( BindEditorTickerHandle );
+		if ( GEditor )
+		{
+			GEditor->OnBlueprintCompiled().Remove( BlueprintCompiledHandle );
+		}
+	}
+
+	/** Bind to the editor once it exists, keeps ticking until then. */
+	bool BindEditor( float DeltaTime )
+	{
+		if ( !GEditor )
+		{
+			return true;
+		}
+
+		BlueprintCompiledHandle = GEditor->OnBlueprintCompiled().AddStatic( &FGameObjectEd::OnBlueprintCompiled );
+		FBlueprintEventCache::InvalidateAll();
+		BindEditorTickerHandle.Reset();
+		return false;
+	}
+
+	static void OnBlueprintCompiled()
+	{
+		// A compiled Blueprint may have gained or lost event implementations, and its objects have been reinstanced.
+		FBlueprintEventCache::InvalidateAll();
+		UGameObjectTree::RebuildAllClassIndices();
 	}
+
+	FDelegateHandle BindEditorTickerHandle;
+
+	FDelegateHandle BlueprintCompiledHandle;
 };
 
 IMPLEMENT_GAME_MODULE(FGameObjectEd, GameObjectEd)
\ No newline at end of file
@@ -6,6 +6,7 @@
 #include "Components/CanvasPanelSlot.h"
 #include "Kismet/GameplayStatics.h"
 #include "GUIDynamicCanvas.h"
+#include "GameStats.h"
 
 UGUIDynamicCanvas::UGUIDynamicCanvas(const FObjectInitializer& Initializer)
 	: Super(Initializer)
@@ -233,6 +234,8 @@ void UGUIDynamicCanvas::NativeTick(const FGeometry& MyGeometry, float InDeltaTim
 {
 	Super::NativeTick(MyGeometry, InDeltaTime);
 
+	SCOPE_CYCLE_COUNTER(STAT_GameModules_DynamicCanvasTick);
+
 	if (AttachedWidgetDataList.Num() > 0)
 	{
 		for (const auto& Data : AttachedWidgetDataList)
@@ -278,6 +281,8 @@ void UGUIDynamicCanvas::UpdateAttachedWidget(const FAttachedWidgetData& Data)
 		return;
 	}
 
+	INC_DWORD_STAT(STAT_GameModules_WidgetsProjected);
+
 	FVector WorldLocation = Data.SceneComponent->GetSocketLocation(Data.SocketName);
 	FVector2D ScreenLocation;
 	UGameplayStatics::ProjectWorldToScreen(GetOwningPlayer(), WorldLocation, ScreenLocation);
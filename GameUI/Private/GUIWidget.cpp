@@ -3,6 +3,30 @@
 #include "Components/PanelWidget.h"
 #include "GUIPlayerController.h"
 #include "GUIWidget.h"
+#include "Util/BlueprintEventCache.h"
+#include "GameStats.h"
+
+/** Blueprint events of UGUIWidget, in the order of their names in WidgetEvents. */
+enum EGUIWidgetEvent
+{
+	GWE_InputKeyPressed,
+	GWE_InputKeyReleased,
+	GWE_InputKeyRepeat,
+	GWE_AllowInputKeyChanged,
+	GWE_InputKeyFocusReceived,
+	GWE_InputKeyFocusLost,
+	GWE_ChildThatHasInputKeyFocusChanged,
+};
+
+static FBlueprintEventCache WidgetEvents( {
+	TEXT("OnInputKeyPressed"),
+	TEXT("OnInputKeyReleased"),
+	TEXT("OnInputKeyRepeat"),
+	TEXT("OnAllowInputKeyChanged"),
+	TEXT("OnInputKeyFocusReceived"),
+	TEXT("OnInputKeyFocusLost"),
+	TEXT("OnChildThatHasInputKeyFocusChanged"),
+} );
 
 UGUIWidget::UGUIWidget(const FObjectInitializer& ObjectInitializer)
 	: Super(ObjectInitializer)
@@ -264,6 +288,8 @@ void UGUIWidget::NativeDestruct()
 
 void UGUIWidget::NativeTick(const FGeometry& MyGeometry, float InDeltaTime)
 {
+	SCOPE_CYCLE_COUNTER( STAT_GameModules_WidgetTick );
+
 	Super::NativeTick(MyGeometry, InDeltaTime);
 
 	if ( OpenCloseTween->IsTweening() )
@@ -291,37 +317,54 @@ void UGUIWidget::OnOpenCloseTweening_Implementation(float Alpha)
 	SetColorAndOpacity(Color);
 }
 
+// Input keys bubble through every widget on the way, so the widgets that do not handle them are skipped without calling Blueprint.
+
 bool UGUIWidget::NativeOnInputKeyPressed(EGUIInputKeyPhase Phase, FKey Key, float AmountDepressed, bool bGamepad)
 {
-	return OnInputKeyPressed(Phase, Key, AmountDepressed, bGamepad).NativeReply.IsEventHandled();
+	return WidgetEvents.IsImplemented(this, GWE_InputKeyPressed) 
+		&& OnInputKeyPressed(Phase, Key, AmountDepressed, bGamepad).NativeReply.IsEventHandled();
 }
 
 bool UGUIWidget::NativeOnInputKeyReleased(EGUIInputKeyPhase Phase, FKey Key, float AmountDepressed, bool bGamepad)
 {
-	return OnInputKeyReleased(Phase, Key, AmountDepressed, bGamepad).NativeReply.IsEventHandled();
+	return WidgetEvents.IsImplemented(this, GWE_InputKeyReleased) 
+		&& OnInputKeyReleased(Phase, Key, AmountDepressed, bGamepad).NativeReply.IsEventHandled();
 }
 
 bool UGUIWidget::NativeOnInputKeyRepeat(EGUIInputKeyPhase Phase, FKey Key, float AmountDepressed, bool bGamepad)
 {
-	return OnInputKeyRepeat(Phase, Key, AmountDepressed, bGamepad).NativeReply.IsEventHandled();
+	return WidgetEvents.IsImplemented(this, GWE_InputKeyRepeat) 
+		&& OnInputKeyRepeat(Phase, Key, AmountDepressed, bGamepad).NativeReply.IsEventHandled();
 }
 
 void UGUIWidget::NativeOnAllowInputKeyChanged(bool bFlag)
 {
-	OnAllowInputKeyChanged(bFlag);
+	if (WidgetEvents.IsImplemented(this, GWE_AllowInputKeyChanged))
+	{
+		OnAllowInputKeyChanged(bFlag);
+	}
 }
 
 void UGUIWidget::NativeOnInputKeyFocusReceived()
 {
-	OnInputKeyFocusReceived();
+	if (WidgetEvents.IsImplemented(this, GWE_InputKeyFocusReceived))
+	{
+		OnInputKeyFocusReceived();
+	}
 }
 
 void UGUIWidget::NativeOnInputKeyFocusLost()
 {
-	OnInputKeyFocusLost();
+	if (WidgetEvents.IsImplemented(this, GWE_InputKeyFocusLost))
+	{
+		OnInputKeyFocusLost();
+	}
 }
 
 void UGUIWidget::NativeOnChildThatHasInputKeyFocusChanged(UGUIWidget* PreviousChild, UGUIWidget* NewChild)
 {
-	OnChildThatHasInputKeyFocusChanged(PreviousChild, NewChild);
+	if (WidgetEvents.IsImplemented(this, GWE_ChildThatHasInputKeyFocusChanged))
+	{
+		OnChildThatHasInputKeyFocusChanged(PreviousChild, NewChild);
+	}
 }